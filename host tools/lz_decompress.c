@@ -0,0 +1,199 @@
+/**
+ * @file    lz_decompress.c
+ * @brief   Host-side decompressor for the monitor's compressed dumps.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Reads a capture of the serial output from stdin, skips everything up to (and including)
+ *          the "#LZ" line the monitor sends before a compressed dump,
+ *          and writes the decompressed data to stdout until the end of stream marker.
+ *          See lz_stream.h for the stream format.
+ * @details With -s the decompressed data is unpacked from the sniffer's packed chunks
+ *          (see Bridge_Pack() in bridge.c) back into 4-byte records.
+ * @details With -i the decompressed data is taken as "irqmon dump z" records:
+ *          5 bytes, [header][32-bit LE stamp], where the stamp is the cycles since the previous record
+ *          (the first one since 0). The stamps are summed back up into cycle counter values.
+ *          Without -i those records come out with the delta stamps as sent.
+ *
+ *          Build:  gcc -O2 -o lz_decompress lz_decompress.c
+ *          Use:    lz_decompress < capture.bin > dump.bin
+ *                  lz_decompress -s < sniff.bin > records.bin
+ *                  lz_decompress -i < irqmon.bin > records.bin
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_WINDOW_SIZE  256
+#define LZ_MIN_MATCH    3
+#define LZ_CTRL_MATCH   0x80
+#define LZ_CTRL_END     0xFF
+
+#define SNIFF_RECORD_SYNC   0xA0
+#define SNIFF_CHUNK_MAX     (1 + 32 + 4*255)    // count byte, bitmap, 3 byte deltas and data for 255 records
+
+#define IRQMON_RECORD_SIZE  5
+
+enum MODES {MODE_RAW, MODE_SNIFF, MODE_IRQMON};
+
+static const char LZ_MARKER[] = {"#LZ\n"};
+
+static uint8_t chunk[SNIFF_CHUNK_MAX];
+static size_t chunk_len;
+static uint32_t irqmon_stamp;
+
+/**
+ * @brief   Skips the input up to and including the "#LZ" marker line.
+ * @return  [int] 0 if the marker was found, -1 if the input ended first.
+ */
+static int skip_to_marker(FILE* in)
+{
+    size_t matched = 0;
+    int c;
+
+    while ((c = fgetc(in)) != EOF) {
+        if (c == '\r') continue;    // terminals may add CRs
+        matched = (c == LZ_MARKER[matched]) ? matched + 1 : (c == LZ_MARKER[0]);
+        if (matched == strlen(LZ_MARKER)) return 0;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief   Finds the length of the packed sniffer chunk in the chunk buffer.
+ * @return  [size_t] Chunk length, 0 if more bytes are needed to tell.
+ */
+static size_t sniff_chunk_length(void)
+{
+    size_t count, pos, i;
+
+    if (chunk_len == 0) return 0;
+    count = chunk[0];
+    pos = 1 + (count + 7)/8;
+
+    for (i = 0; i < count; i++) {
+        do {
+            if (pos >= chunk_len) return 0;
+        } while (chunk[pos++] & 0x80);
+    }
+
+    return pos + count;
+}
+
+/**
+ * @brief   Writes the records of the packed sniffer chunk in the chunk buffer.
+ */
+static void sniff_write_records(void)
+{
+    size_t count = chunk[0], pos = 1 + (count + 7)/8, data = sniff_chunk_length() - count, i;
+    uint32_t delta, shift;
+
+    for (i = 0; i < count; i++) {
+        delta = 0;
+        shift = 0;
+        do {
+            delta |= (uint32_t)(chunk[pos] & 0x7F) << shift;
+            shift += 7;
+        } while (chunk[pos++] & 0x80);
+
+        putchar(SNIFF_RECORD_SYNC | ((chunk[1 + i/8] >> (i % 8)) & 1));
+        putchar(delta & 0xFF);
+        putchar((delta >> 8) & 0xFF);
+        putchar(chunk[data + i]);
+    }
+}
+
+/**
+ * @brief   Writes the irqmon record in the chunk buffer, with its delta stamp added to the running stamp.
+ */
+static void irqmon_write_record(void)
+{
+    uint32_t delta = chunk[1] | (chunk[2] << 8) | (chunk[3] << 16) | ((uint32_t)chunk[4] << 24);
+
+    irqmon_stamp += delta;
+    putchar(chunk[0]);
+    putchar(irqmon_stamp & 0xFF);
+    putchar((irqmon_stamp >> 8) & 0xFF);
+    putchar((irqmon_stamp >> 16) & 0xFF);
+    putchar((irqmon_stamp >> 24) & 0xFF);
+}
+
+/**
+ * @brief   Outputs a decompressed byte, straight or through the sniffer/irqmon record unpackers.
+ */
+static void emit(uint8_t c, int mode)
+{
+    if (mode == MODE_RAW) {
+        putchar(c);
+        return;
+    }
+
+    chunk[chunk_len++] = c;
+    if (mode == MODE_SNIFF && sniff_chunk_length() == chunk_len) {
+        sniff_write_records();
+        chunk_len = 0;
+    }
+    else if (mode == MODE_IRQMON && chunk_len == IRQMON_RECORD_SIZE) {
+        irqmon_write_record();
+        chunk_len = 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t window[LZ_WINDOW_SIZE];
+    uint32_t pos = 0, length, offset;
+    int mode = MODE_RAW;
+    int c;
+
+    if (argc > 1 && strcmp(argv[1], "-s") == 0) mode = MODE_SNIFF;
+    else if (argc > 1 && strcmp(argv[1], "-i") == 0) mode = MODE_IRQMON;
+    else if (argc > 1) {
+        fprintf(stderr, "usage: lz_decompress [-s | -i] < capture.bin > records.bin\n"
+                        "  -s: unpack sniffer chunks into 4-byte records\n"
+                        "  -i: sum irqmon delta stamps back into cycle counter values (5-byte records)\n");
+        return 1;
+    }
+
+    if (skip_to_marker(stdin)) {
+        fprintf(stderr, "lz_decompress: no #LZ marker in input\n");
+        return 1;
+    }
+
+    while ((c = fgetc(stdin)) != EOF && c != LZ_CTRL_END) {
+        if (c & LZ_CTRL_MATCH) {
+            length = (c & ~LZ_CTRL_MATCH) + LZ_MIN_MATCH;
+            if ((c = fgetc(stdin)) == EOF) break;
+            offset = c + 1;
+
+            while (length--) {
+                window[pos % LZ_WINDOW_SIZE] = window[(pos - offset) % LZ_WINDOW_SIZE];
+                emit(window[pos % LZ_WINDOW_SIZE], mode);
+                pos++;
+            }
+        }
+        else {
+            length = c + 1;
+
+            while (length-- && (c = fgetc(stdin)) != EOF) {
+                window[pos % LZ_WINDOW_SIZE] = c;
+                emit(c, mode);
+                pos++;
+            }
+        }
+    }
+
+    if (c != LZ_CTRL_END) {
+        fprintf(stderr, "lz_decompress: stream ended without an end marker\n");
+        return 1;
+    }
+    if (chunk_len) {
+        fprintf(stderr, "lz_decompress: stream ended in the middle of a record\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+
+/**
+ * @file    baud.c
+ * @brief   Console line error policy: steps the UART0 baud rate down on noisy links, and back up once they're quiet.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Line errors are looked at once per window (BAUD_WINDOW_TICKS).
+ *          BAUD_BAD_WINDOWS windows in a row with BAUD_ERR_LIMIT errors or more step the rate down a level,
+ *          BAUD_QUIET_WINDOWS error free windows in a row step it back up a level.
+ * @details Rate changes are a handshake with the host:
+ *          - the board announces "#BAUD <new rate>" at the old rate, and switches once it's been sent,
+ *          - the host switches too, and sends "baud ok" at the new rate,
+ *          - if that doesn't come within BAUD_CONFIRM_WINDOWS, the board goes back to the old rate
+ *            and announces "#BAUD <old rate> REVERT" there.
+ *          Manual changes ("baud <rate>") go through the same handshake.
+ * @details The thresholds are tunables (BAUD_ERR_LIMIT and friends are their defaults).
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include "baud.h"
+#include "uart.h"
+#include "systime.h"
+#include "bridge.h"
+#include "flightrec.h"
+#include "tunables.h"
+
+/** Rate table, fastest first. The first rate must be the UART0 rate out of reset. */
+static const uint32_t BAUD_LEVELS[] = {UART0_BAUD, 57600, 38400, 19200, 9600};
+
+#define BAUD_LEVEL_COUNT    (sizeof(BAUD_LEVELS)/sizeof(BAUD_LEVELS[0]))
+
+static baud_policy_t policy;
+
+static void Baud_Window(void);
+static void Baud_Switch(uint8_t level, bool confirm);
+static uint32_t Baud_Errors(void);
+
+/**
+ * @brief   Initializes the baud rate policy (automatic fallback enabled).
+ * @details Make sure the UART driver and systime have been initialized prior to calling this function,
+ *          the windows are timed by a systime tick hook.
+ */
+void Baud_Init(void)
+{
+    memset(&policy, 0, sizeof(policy));
+    policy.auto_en = true;
+    policy.last_errors = Baud_Errors();
+
+    systime_AddTickHook(Baud_Tick);
+}
+
+/**
+ * @brief   Services the baud query.
+ * @param   [in] args: query set data (NULL if there is none). Supported forms:
+ *          - (none):       report the rate, the policy state and the line error counters,
+ *          - OK:           confirm a rate change (sent by the host at the new rate),
+ *          - AUTO ON/OFF:  enable/disable the automatic fallback,
+ *          - <rate>:       change to one of the rates in the table.
+ * @return  [bool] True if the arguments were valid.
+ */
+bool Baud_Query(char* args)
+{
+    uart_line_errors_t errors;
+    unsigned int baud;
+    char trailing, row_str[112];    // nine 10 digit counters and the state
+    uint8_t level;
+
+    if (args == NULL) {
+        UART0_GetLineErrors(&errors);
+        UART0_puts("baud,auto,state,overrun,break,parity,framing,steps_down,steps_up,reverts\n");
+        sprintf(row_str, "%u,%u,%s,%u,%u,%u,%u,%u,%u,%u\n",
+                UART0_GetBaud(), policy.auto_en, (policy.state == BAUD_STABLE) ? "stable" : "confirming",
+                errors.overrun, errors.brk, errors.parity, errors.framing,
+                policy.steps_down, policy.steps_up, policy.reverts);
+        UART0_puts(row_str);
+    }
+    else if (strcmp(args, "OK") == 0) {
+        if (policy.state != BAUD_CONFIRMING) return false;
+        policy.state = BAUD_STABLE;
+    }
+    else if (strcmp(args, "AUTO ON") == 0) {
+        policy.auto_en = true;
+    }
+    else if (strcmp(args, "AUTO OFF") == 0) {
+        policy.auto_en = false;
+    }
+    else if (sscanf(args, "%u%c", &baud, &trailing) == 1) {
+        for (level = 0; level < BAUD_LEVEL_COUNT && BAUD_LEVELS[level] != baud; level++) ;
+        if (level == BAUD_LEVEL_COUNT || policy.state != BAUD_STABLE) return false;
+
+        if (level != policy.level) Baud_Switch(level, true);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Baud policy update function, called from the main loop.
+ * @details Evaluates the window that just ended, if any.
+ *          Nothing is changed while the sniffer streams binary data on the console.
+ */
+void Baud_Update(void)
+{
+    if (policy.window && !Bridge_Sniffing()) {
+        policy.window = false;
+        Baud_Window();
+    }
+}
+
+/**
+ * @brief   Baud policy tick function.
+ * @details Registered as a systime tick hook, flags the end of every window.
+ */
+void Baud_Tick(void)
+{
+    if (++policy.ticks >= BAUD_WINDOW_TICKS) {
+        policy.ticks = 0;
+        policy.window = true;
+    }
+}
+
+/**
+ * @brief   Evaluates a window: reverts unconfirmed changes, or applies the fallback policy.
+ */
+static void Baud_Window(void)
+{
+    uint32_t errors = Baud_Errors();
+    uint32_t window_errors = errors - policy.last_errors;
+
+    policy.last_errors = errors;
+
+    if (policy.state == BAUD_CONFIRMING) {
+        if (++policy.confirm_windows >= Tunables_Get(TUNE_BAUD_CONFIRM_WINDOWS)) {
+            policy.reverts++;
+            Baud_Switch(policy.prev_level, false);
+        }
+        return;
+    }
+
+    if (window_errors >= (uint32_t)Tunables_Get(TUNE_BAUD_ERR_LIMIT)) {
+        policy.bad_windows++;
+        policy.quiet_windows = 0;
+    }
+    else if (window_errors == 0) {
+        policy.quiet_windows++;
+        policy.bad_windows = 0;
+    }
+    else {
+        policy.bad_windows = 0;
+        policy.quiet_windows = 0;
+    }
+
+    if (!policy.auto_en) return;
+
+    if (policy.bad_windows >= Tunables_Get(TUNE_BAUD_BAD_WINDOWS) && policy.level < BAUD_LEVEL_COUNT - 1) {
+        policy.steps_down++;
+        Baud_Switch(policy.level + 1, true);
+    }
+    else if (policy.quiet_windows >= Tunables_Get(TUNE_BAUD_QUIET_WINDOWS) && policy.level > 0) {
+        policy.steps_up++;
+        Baud_Switch(policy.level - 1, true);
+    }
+}
+
+/**
+ * @brief   Announces and changes the baud rate.
+ * @param   [in] level: rate table index to change to.
+ * @param   [in] confirm: True if the host has to confirm the new rate, false for a revert.
+ * @details The announcement (and anything queued before it) is sent at the old rate.
+ *          A revert is announced at the rate being gone back to, where the host still is.
+ * @details The idle check and the rate change share one critical section, otherwise the alarm
+ *          (which writes from the SysTick interrupt) could queue bytes in between.
+ */
+static void Baud_Switch(uint8_t level, bool confirm)
+{
+    char announce_str[32];
+    uint32_t primask;
+    bool idle;
+
+    sprintf(announce_str, "\n#BAUD %u%s\n", BAUD_LEVELS[level], confirm ? "" : " REVERT");
+
+    if (confirm) {
+        UART0_puts(announce_str);
+    }
+    do {
+        while (!UART0_TxIdle()) ;
+
+        primask = IRQ_SAVE();
+        idle = UART0_TxIdle();
+        if (idle) UART0_SetBaud(BAUD_LEVELS[level]);
+        IRQ_RESTORE(primask);
+    } while (!idle);
+    FlightRec_Trace(FLIGHTREC_BAUD, level, BAUD_LEVELS[level] / 100);
+
+    if (!confirm) {
+        UART0_puts(announce_str);
+    }
+
+    policy.prev_level = policy.level;
+    policy.level = level;
+    policy.state = confirm ? BAUD_CONFIRMING : BAUD_STABLE;
+    policy.confirm_windows = 0;
+    policy.bad_windows = 0;
+    policy.quiet_windows = 0;
+    policy.last_errors = Baud_Errors();     // errors from switching over don't count against the new rate
+}
+
+/**
+ * @brief   Gets the total of the UART0 line error counters.
+ */
+static uint32_t Baud_Errors(void)
+{
+    uart_line_errors_t errors;
+
+    UART0_GetLineErrors(&errors);
+
+    return errors.overrun + errors.brk + errors.parity + errors.framing;
+}
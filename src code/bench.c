@@ -0,0 +1,235 @@
+
+/**
+ * @file    bench.c
+ * @brief   On-device microbenchmarks for the monitor's hot paths.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Every benchmark times its statement individually with the DWT cycle counter,
+ *          so flash wait states and bus timing of the actual board are part of the numbers.
+ *          The cost of reading the cycle counter itself is calibrated once per run and subtracted.
+ * @details Interrupts are disabled while a row is measured (apart from the UART TX row, which needs them),
+ *          so keep the link quiet while the benchmarks run.
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "circular_buffer.h"
+#include "systime.h"
+#include "query_handler.h"
+#include "uart.h"
+
+static const uint32_t BENCH_LENGTHS[] = {1, 8, 32, 96};   /// Byte lengths used for the enqueue/dequeue rows
+
+static uint32_t overhead;               /// Cycles spent by an empty BENCH_TIME
+static circular_buffer_t bench_buf;     /// Scratch buffer for the circular buffer rows
+static char bench_data[CIRCULAR_BUFFER_SIZE];
+
+static void Bench_Calibrate(void);
+static void Bench_Report(const char* name, uint32_t length, uint32_t iterations, uint32_t cycles);
+static void Bench_Buffer(void);
+static void Bench_Systime(void);
+static void Bench_Query(void);
+static void Bench_UartTx(void);
+
+/**
+ * @brief   Runs every benchmark and prints the results.
+ * @details Output is a comma-separated table, so it can be diffed between firmware builds:
+ *          "#BENCH", the column header "name,len,iters,cyc_per_op", one row per benchmark, then "#END".
+ *          cyc_per_op has one decimal place.
+ */
+void Bench_Run(void)
+{
+    CYCCNT_ENABLE();
+
+    memset(bench_data, 'x', sizeof(bench_data));
+    circular_buffer_init(&bench_buf);
+
+    UART0_puts("#BENCH\nname,len,iters,cyc_per_op\n");
+
+    Bench_Calibrate();
+    Bench_Buffer();
+    Bench_Systime();
+    Bench_Query();
+    Bench_UartTx();
+
+    UART0_puts("#END\n");
+}
+
+/**
+ * @brief   Measures the cost of an empty timed statement.
+ */
+static void Bench_Calibrate(void)
+{
+    uint32_t i, cycles = 0;
+
+    DISABLE_IRQ();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        BENCH_TIME(cycles, );
+    }
+    ENABLE_IRQ();
+
+    overhead = cycles / BENCH_ITERATIONS;
+}
+
+/**
+ * @brief   Prints a benchmark row.
+ * @param   [in] name: benchmark name.
+ * @param   [in] length: bytes per operation (0 if not applicable).
+ * @param   [in] iterations: amount of timed operations.
+ * @param   [in] cycles: total cycles measured over all the iterations.
+ */
+static void Bench_Report(const char* name, uint32_t length, uint32_t iterations, uint32_t cycles)
+{
+    char row_str[64];
+    uint32_t calibrated = overhead * iterations;
+    uint32_t per_op_x10;
+
+    cycles = (cycles > calibrated) ? (cycles - calibrated) : 0;
+    per_op_x10 = (cycles * 10) / iterations;
+
+    sprintf(row_str, "%s,%u,%u,%u.%u\n", name, length, iterations, per_op_x10 / 10, per_op_x10 % 10);
+    UART0_puts(row_str);
+}
+
+/**
+ * @brief   Circular buffer benchmarks.
+ * @details The scratch buffer isn't reset between iterations,
+ *          so the pointers wrap around and the split-copy paths get measured too.
+ */
+static void Bench_Buffer(void)
+{
+    uint32_t i, l, enq_cycles = 0, deq_cycles = 0;
+    uint8_t dst[CIRCULAR_BUFFER_SIZE];
+    char c;
+
+    DISABLE_IRQ();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        BENCH_TIME(enq_cycles, enqueuec(&bench_buf, 'x'));
+        BENCH_TIME(deq_cycles, c = dequeuec(&bench_buf));
+    }
+    ENABLE_IRQ();
+    (void)c;
+
+    Bench_Report("enqueuec", 1, BENCH_ITERATIONS, enq_cycles);
+    Bench_Report("dequeuec", 1, BENCH_ITERATIONS, deq_cycles);
+
+    for (l = 0; l < sizeof(BENCH_LENGTHS)/sizeof(BENCH_LENGTHS[0]); l++) {
+        enq_cycles = 0;
+        deq_cycles = 0;
+
+        DISABLE_IRQ();
+        for (i = 0; i < BENCH_ITERATIONS; i++) {
+            BENCH_TIME(enq_cycles, enqueue(&bench_buf, bench_data, BENCH_LENGTHS[l]));
+            BENCH_TIME(deq_cycles, dequeue(&bench_buf, dst, BENCH_LENGTHS[l]));
+        }
+        ENABLE_IRQ();
+
+        Bench_Report("enqueue", BENCH_LENGTHS[l], BENCH_ITERATIONS, enq_cycles);
+        Bench_Report("dequeue", BENCH_LENGTHS[l], BENCH_ITERATIONS, deq_cycles);
+    }
+}
+
+/**
+ * @brief   Systime benchmarks.
+ * @details The date rollover row is the cost of incrementing the date from the 31st of December,
+ *          the (separately measured) cost of setting the date back up is taken out of it.
+ *          The system date is restored afterwards.
+ */
+static void Bench_Systime(void)
+{
+    uint32_t i, get_cycles = 0, inc_cycles = 0, set_cycles = 0, rollover_cycles = 0;
+    date_t saved_date, new_year_eve = {.year = 2019, .month = 12, .day = 31};
+    clock_t clock_temp;
+#if SYSTIME_ASCII_CLOCK
+    uint32_t str_cycles = 0;
+    char time_str[SYSTIME_CLOCK_STR_LEN + 1];
+#endif
+
+    systime_GetDate(&saved_date);
+
+    DISABLE_IRQ();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        BENCH_TIME(get_cycles, systime_GetTime(&clock_temp));
+        BENCH_TIME(inc_cycles, systime_IncDate_callback());
+#if SYSTIME_ASCII_CLOCK
+        BENCH_TIME(str_cycles, systime_GetTimeStr(time_str));
+#endif
+    }
+
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        BENCH_TIME(set_cycles, systime_SetDate(&new_year_eve));
+        BENCH_TIME(rollover_cycles, systime_SetDate(&new_year_eve); systime_IncDate_callback());
+    }
+    rollover_cycles = (rollover_cycles > set_cycles) ? (rollover_cycles - set_cycles) : 0;
+
+    systime_SetDate(&saved_date);
+    ENABLE_IRQ();
+
+    Bench_Report("systime_gettime", 0, BENCH_ITERATIONS, get_cycles);
+#if SYSTIME_ASCII_CLOCK
+    Bench_Report("systime_gettimestr", SYSTIME_CLOCK_STR_LEN, BENCH_ITERATIONS, str_cycles);
+#endif
+    Bench_Report("date_inc", 0, BENCH_ITERATIONS, inc_cycles);
+    Bench_Report("date_rollover", 0, BENCH_ITERATIONS, rollover_cycles);
+}
+
+/**
+ * @brief   Query parse and format benchmarks.
+ * @details Uses the same formats as the query handler.
+ *          Alarm queries share the time formats, so they're covered by the time rows.
+ */
+static void Bench_Query(void)
+{
+    uint32_t i, time_scan = 0, time_print = 0, date_scan = 0, date_print = 0;
+    char time_set[] = {"12:34:56.7"};
+    char date_set[] = {"18-OCT-2026"};
+    char month_str[10];
+    char out_str[32];
+    clock_t clock_temp;
+    date_t date_temp;
+
+    DISABLE_IRQ();
+    for (i = 0; i < BENCH_ITERATIONS; i++) {
+        BENCH_TIME(time_scan, sscanf(time_set, TIME_SCAN_FORMAT,
+                                     &clock_temp.hour, &clock_temp.min,
+                                     &clock_temp.sec, &clock_temp.t_sec));
+        BENCH_TIME(time_print, sprintf(out_str, TIME_PRINT_FORMAT,
+                                       clock_temp.hour, clock_temp.min,
+                                       clock_temp.sec, clock_temp.t_sec));
+        BENCH_TIME(date_scan, sscanf(date_set, DATE_SCAN_FORMAT,
+                                     &date_temp.day, month_str, &date_temp.year));
+        BENCH_TIME(date_print, sprintf(out_str, DATE_PRINT_FORMAT,
+                                       date_temp.day, month_str, date_temp.year));
+    }
+    ENABLE_IRQ();
+
+    Bench_Report("parse_time", 0, BENCH_ITERATIONS, time_scan);
+    Bench_Report("format_time", 0, BENCH_ITERATIONS, time_print);
+    Bench_Report("parse_date", 0, BENCH_ITERATIONS, date_scan);
+    Bench_Report("format_date", 0, BENCH_ITERATIONS, date_print);
+}
+
+/**
+ * @brief   UART TX benchmark.
+ * @details Times queuing BENCH_TX_LENGTH bytes into an idle TX buffer with UART0_put
+ *          (which also primes the TX FIFO). The bytes sent are a comment line of the report.
+ */
+static void Bench_UartTx(void)
+{
+    uint32_t i, cycles = 0, iterations = BENCH_ITERATIONS / 8;
+    char tx_line[BENCH_TX_LENGTH];
+
+    memset(tx_line, '-', sizeof(tx_line));
+    tx_line[0] = '#';
+    tx_line[BENCH_TX_LENGTH-1] = '\n';
+
+    for (i = 0; i < iterations; i++) {
+        while (!UART0_TxIdle()) ;
+        BENCH_TIME(cycles, UART0_put(tx_line, BENCH_TX_LENGTH));
+    }
+    while (!UART0_TxIdle()) ;
+
+    Bench_Report("uart_put", BENCH_TX_LENGTH, iterations, cycles);
+}
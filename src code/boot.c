@@ -0,0 +1,87 @@
+
+/**
+ * @file    boot.c
+ * @brief   Boot-time profiling.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Stamps every initialization phase with the DWT cycle counter,
+ *          from the start of main until the first prompt is out of the UART and the first query is answered.
+ */
+
+#include <stdio.h>
+#include "cpu.h"
+#include "boot.h"
+#include "uart.h"
+
+#define BOOT_CYC_PER_US (F_CPU_CLK/1000000)
+
+/** Boot phase names, in BOOT_PHASES order */
+static const char* const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "main", "uart_init", "systime_init", "irqmon_init",
+    "systick_start", "query_init", "first_prompt", "first_query"
+};
+
+static boot_profile_t boot;
+
+/**
+ * @brief   Starts the boot profile.
+ * @details Must be the first thing main does, since it starts the cycle counter.
+ */
+void Boot_Start(void)
+{
+    CYCCNT_ENABLE();
+    CPU_DWT_CYCCNT_R = 0;
+
+    boot.done = 0;
+    Boot_Mark(BOOT_MAIN);
+}
+
+/**
+ * @brief   Marks a boot phase as completed.
+ * @param   [in] phase: completed phase (see BOOT_PHASES).
+ * @details Only the first mark of a phase counts, so it's safe to call from recurring paths.
+ */
+void Boot_Mark(uint8_t phase)
+{
+    if (!(boot.done & (1 << phase))) {
+        boot.stamps[phase] = CYCCNT();
+        boot.done |= (1 << phase);
+    }
+}
+
+/**
+ * @brief   Boot profile update function, called from the main loop.
+ * @details Marks the first prompt once the banner has completely left the UART.
+ */
+void Boot_Update(void)
+{
+    if (!(boot.done & (1 << BOOT_FIRST_PROMPT)) && UART0_TxIdle()) {
+        Boot_Mark(BOOT_FIRST_PROMPT);
+    }
+}
+
+/**
+ * @brief   Prints the boot profile.
+ * @details "phase,us,delta_us" rows, in microseconds since main and since the previous phase.
+ *          Phases that haven't happened yet are left out.
+ */
+void Boot_Report(void)
+{
+    char row_str[48];
+    uint32_t prev = boot.stamps[BOOT_MAIN];
+    uint8_t phase;
+
+    UART0_puts("phase,us,delta_us\n");
+
+    for (phase = 0; phase < BOOT_PHASE_COUNT; phase++) {
+        if (boot.done & (1 << phase)) {
+            sprintf(row_str, "%s,%u,%u\n", BOOT_PHASE_NAMES[phase],
+                    (boot.stamps[phase] - boot.stamps[BOOT_MAIN]) / BOOT_CYC_PER_US,
+                    (boot.stamps[phase] - prev) / BOOT_CYC_PER_US);
+            UART0_puts(row_str);
+            prev = boot.stamps[phase];
+        }
+    }
+}
@@ -0,0 +1,262 @@
+
+/**
+ * @file    bridge.c
+ * @brief   Transparent UART bridge and passive line sniffer.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Bridges UART2 and UART3 in both directions straight from their interrupt handlers
+ *          (RX FIFO -> other side's TX FIFO, overflowing into its TX buffer),
+ *          so the bridged link never waits on the main loop or on the console.
+ * @details Every bridged byte is also captured as a 4-byte timestamped record (see bridge_record_t)
+ *          into a capture buffer that the main loop streams out the console UART.
+ *          The console has to run faster than the bridged traffic for the capture to keep up
+ *          (4 bytes out per byte bridged), when it can't, records are dropped and counted.
+ *          With the console at 115200 (11520 bytes/s), uncompressed captures keep up with 2880 bridged bytes/s
+ *          sustained, which is a quarter of one direction at BRIDGE_BAUD: full duplex at line rate (23040 bytes/s)
+ *          only fits in bursts of up to CIRCULAR_BUFFER_SIZE/4 records. Raise the console rate ("baud")
+ *          or use "sniff z" for busier links.
+ * @details Bridged bytes are only dropped if the destination's TX buffer is full
+ *          (a sender running faster than its nominal rate), they're counted separately.
+ *          Line errors are counted by the ports: bytes received with a break, parity or framing error
+ *          aren't bridged or captured, and an overrun means the byte after it was lost.
+ * @details The capture stream can be LZ compressed on the fly (see lz_stream.h).
+ *          Each chunk of records is packed first (see Bridge_Pack()), so the data bytes are contiguous
+ *          and the near constant headers and deltas shrink before LZ sees them.
+ */
+
+#include <string.h>
+#include "bridge.h"
+#include "uart.h"
+#include "isr_stats.h"
+#include "tunables.h"
+
+static bridge_t bridge;
+
+static void Bridge_Forward(uart_port_t* port, char c);
+static void Bridge_Drain(bool flush);
+static uint32_t Bridge_Pack(const uint8_t* records, uint32_t count, uint8_t* dst);
+
+/**
+ * @brief   Starts the bridge and the capture stream.
+ * @param   [in] compress: True to LZ compress the capture stream (announced by a "#LZ" line).
+ * @details Turns the console echo off, since everything after the "#SNIFF" line is binary.
+ *          Any byte received on the console stops the sniffer.
+ */
+void Bridge_Start(bool compress)
+{
+    UART0_puts("#SNIFF\n");
+    bridge.compress = compress;
+    if (compress) {
+        lz_init(&bridge.lz);
+        UART0_puts("#LZ\n");
+    }
+    while (!UART0_TxIdle()) ;
+
+    circular_buffer_init(&bridge.capture);
+    bridge.records = 0;
+    bridge.dropped = 0;
+    bridge.fwd_dropped = 0;
+    bridge.echo_restore = UART0_SetEcho(UART0_ECHO_OFF);
+
+    CYCCNT_ENABLE();
+    bridge.last_stamp = CYCCNT();
+
+    // UART2/3 pins are on port A, which has already been clocked by the UART0 driver
+    GPIO_PORTA_AFSEL_R |= BRIDGE_PA_PINS;
+    GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R & 0x0000FFFF) | BRIDGE_PA_PCTL;
+    GPIO_PORTA_DEN_R |= BRIDGE_PA_PINS;
+
+    bridge.a.rx_cb = Bridge_Forward;
+    bridge.b.rx_cb = Bridge_Forward;
+    UARTPort_Init(&bridge.a, BRIDGE_UART_A, BRIDGE_BAUD);
+    UARTPort_Init(&bridge.b, BRIDGE_UART_B, BRIDGE_BAUD);
+
+    bridge.en = true;
+
+    UART0_InterruptEnable(INT_VEC_UART2);
+    UART0_InterruptEnable(INT_VEC_UART3);
+}
+
+/**
+ * @brief   Stops the bridge and reports the capture totals.
+ * @details Prints "#END <records> DROP <dropped records> FWD <dropped bridged bytes> ERR <line errors>"
+ *          once the capture has been flushed (and the compressed stream ended).
+ */
+void Bridge_Stop(void)
+{
+    char summary_str[80];
+
+    UARTPort_Disable(&bridge.a);
+    UARTPort_Disable(&bridge.b);
+    bridge.en = false;
+
+    while (buffer_size(&bridge.capture) != BUFFER_EMPTY) {
+        Bridge_Drain(true);
+    }
+    if (bridge.compress) {
+        UART0_write((char[]){LZ_CTRL_END}, 1);
+    }
+
+    UART0_SetEcho(bridge.echo_restore);
+
+    sprintf(summary_str, "\n#END %u DROP %u FWD %u ERR %u\n> ", bridge.records, bridge.dropped, bridge.fwd_dropped,
+            bridge.a.rx_errors + bridge.b.rx_errors);
+    UART0_puts(summary_str);
+}
+
+/**
+ * @brief   Determines if the sniffer currently owns the console.
+ */
+bool Bridge_Sniffing(void)
+{
+    return bridge.en;
+}
+
+/**
+ * @brief   Bridge update function, called from the main loop while sniffing.
+ * @param   [in, out] rx_buf: console receive buffer.
+ * @details Streams the capture out the console,
+ *          and stops the sniffer if anything was typed on the console.
+ */
+void Bridge_Update(circular_buffer_t* rx_buf)
+{
+    Bridge_Drain(false);
+
+    if (buffer_size(rx_buf) != BUFFER_EMPTY) {
+        dequeue(rx_buf, NULL, buffer_size(rx_buf));
+        Bridge_Stop();
+    }
+}
+
+/**
+ * @brief   Moves as much of the capture as the console TX buffer can take.
+ * @param   [in] flush: If false, compressed chunks wait for SNIFF_LZ_CHUNK (a tunable) bytes of capture.
+ * @details Compressed chunks are whole records, records are always queued whole by the bridge interrupts.
+ */
+static void Bridge_Drain(bool flush)
+{
+    uint8_t chunk[CIRCULAR_BUFFER_SIZE];
+    uint8_t records[BRIDGE_PACK_BOUND(CIRCULAR_BUFFER_SIZE/BRIDGE_RECORD_SIZE)];
+    uint8_t packed[LZ_BOUND(sizeof(records))];
+    uint32_t length, count, space = UART0_TxFree();
+
+    if (!bridge.compress) {
+        length = dequeue(&bridge.capture, chunk, space);
+        if (length) {
+            UART0_put((char*)chunk, length);
+        }
+    }
+    else if (flush || buffer_size(&bridge.capture) >= (uint32_t)Tunables_Get(TUNE_SNIFF_LZ_CHUNK)) {
+        count = buffer_size(&bridge.capture) / BRIDGE_RECORD_SIZE;
+        while (count && LZ_BOUND(BRIDGE_PACK_BOUND(count)) > space) count--;
+
+        if (count) {
+            dequeue(&bridge.capture, chunk, count * BRIDGE_RECORD_SIZE);
+            length = Bridge_Pack(chunk, count, records);
+            length = lz_compress(&bridge.lz, records, length, packed);
+            UART0_put((char*)packed, length);
+        }
+    }
+}
+
+/**
+ * @brief   Packs a chunk of capture records for compression.
+ * @param   [in] records: count records (bridge_record_t).
+ * @param   [in] count: number of records, up to 255.
+ * @param   [out] dst: packed chunk, up to BRIDGE_PACK_BOUND(count) bytes.
+ * @return  [uint32_t] Packed chunk length.
+ * @details [count][direction bitmap][deltas][data]: the bitmap has a bit per record (set for B to A, LSB first),
+ *          the deltas are 7 bits per byte, low bits first, with the MSB set on all but the last byte
+ *          (bytes at line rate and FIFO bursts take 1 or 2 bytes instead of 3),
+ *          and the data bytes are left in order so the bridged traffic compresses as such.
+ */
+static uint32_t Bridge_Pack(const uint8_t* records, uint32_t count, uint8_t* dst)
+{
+    const bridge_record_t* record = (const bridge_record_t*)records;
+    uint32_t i, delta, length = 1 + (count + 7)/8;
+
+    dst[0] = count;
+    memset(dst + 1, 0, length - 1);
+
+    for (i = 0; i < count; i++) {
+        if (record[i].header & BRIDGE_DIR_B_TO_A) dst[1 + i/8] |= 1 << (i % 8);
+
+        delta = record[i].delta_lo | (record[i].delta_hi << 8);
+        while (delta >= 0x80) {
+            dst[length++] = 0x80 | (delta & 0x7F);
+            delta >>= 7;
+        }
+        dst[length++] = delta;
+    }
+
+    for (i = 0; i < count; i++) {
+        dst[length++] = record[i].data;
+    }
+
+    return length;
+}
+
+/**
+ * @brief   RX callback shared by both sides of the bridge.
+ * @param   [in] port: port the byte was received on.
+ * @param   [in] c: received byte.
+ * @details Runs in the receiving UART's interrupt handler.
+ *          Both bridge UARTs run at the same interrupt priority, so they never preempt each other.
+ */
+static void Bridge_Forward(uart_port_t* port, char c)
+{
+    uart_port_t* dst = (port == &bridge.a) ? &bridge.b : &bridge.a;
+    bridge_record_t record;
+    uint32_t now, delta;
+
+    if (!enqueuec_s(&dst->tx, c, false)) {
+        bridge.fwd_dropped++;
+    }
+    UARTPort_TxFill(dst);
+
+    now = CYCCNT();
+    delta = (now - bridge.last_stamp) / BRIDGE_CYC_PER_US;
+    if (delta > 0xFFFF) delta = 0xFFFF;
+
+    record.header = BRIDGE_RECORD_SYNC | ((port == &bridge.a) ? BRIDGE_DIR_A_TO_B : BRIDGE_DIR_B_TO_A);
+    record.delta_lo = delta & 0xFF;
+    record.delta_hi = delta >> 8;
+    record.data = c;
+
+    if ((CIRCULAR_BUFFER_MASK - buffer_size(&bridge.capture)) >= BRIDGE_RECORD_SIZE) {
+        enqueue(&bridge.capture, (char*)&record, BRIDGE_RECORD_SIZE);
+        bridge.last_stamp = now;
+        bridge.records++;
+    }
+    else {
+        bridge.dropped++;
+    }
+}
+
+/**
+ * @brief   Interrupt Handler for UART2 (bridge side A).
+ * @details Needs to be registered in the interrupt vector table, like UART0_IntHandler.
+ */
+void UART2_IntHandler(void)
+{
+    ISR_STATS_ENTER();
+
+    UARTPort_IntHandler(&bridge.a);
+
+    ISR_STATS_EXIT(ISR_UART2);
+}
+
+/**
+ * @brief   Interrupt Handler for UART3 (bridge side B).
+ * @details Needs to be registered in the interrupt vector table, like UART0_IntHandler.
+ */
+void UART3_IntHandler(void)
+{
+    ISR_STATS_ENTER();
+
+    UARTPort_IntHandler(&bridge.b);
+
+    ISR_STATS_EXIT(ISR_UART3);
+}
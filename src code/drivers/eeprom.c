@@ -0,0 +1,102 @@
+/**
+ * @file    eeprom.c
+ * @brief   Contains functionality to operate the internal EEPROM of the tiva board.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details The EEPROM is addressed in 32-bit words (address / EEPROM_BLOCK_WORDS is the block,
+ *          the remainder the offset within it). Block protection isn't used, every block is left open.
+ * @details Writes take a few hundred microseconds per word (more if the EEPROM has to copy/erase a sector),
+ *          and the driver busy-waits on them, so keep them out of interrupt handlers.
+ */
+
+#include "eeprom.h"
+
+static bool EEPROM_Wait(void);
+static void EEPROM_Seek(uint32_t address);
+
+/**
+ * @brief   Enables the EEPROM module and checks that it's usable.
+ * @return  [bool] True if the EEPROM is ready, false if it reported an unrecoverable error on power-up.
+ */
+bool EEPROM_Init(void)
+{
+    SYSCTL_RCGCEEPROM_R |= SYSCTL_RCGCEEPROM_R0;                // Enable Clock Gating for the EEPROM
+    while (!(SYSCTL_PREEPROM_R & SYSCTL_RCGCEEPROM_R0)) ;       // Wait until it's ready to be accessed
+
+    EEPROM_Wait();  // the module finishes any operation interrupted by the last reset first
+
+    return !(EEPROM_EESUPP_R & (EEPROM_EESUPP_ERETRY | EEPROM_EESUPP_PRETRY));
+}
+
+/**
+ * @brief   Gets the size of the EEPROM, in 32-bit words.
+ */
+uint32_t EEPROM_Size(void)
+{
+    return EEPROM_EESIZE_R & EEPROM_WORDS_MASK;
+}
+
+/**
+ * @brief   Reads words from the EEPROM.
+ * @param   [in] address: word address of the first word.
+ * @param   [out] data: where the words are copied to.
+ * @param   [in] words: amount of words to read.
+ * @return  [bool] True if the words were read, false if they're out of the EEPROM.
+ */
+bool EEPROM_Read(uint32_t address, uint32_t* data, uint32_t words)
+{
+    if (address + words > EEPROM_Size()) return false;
+
+    while (words--) {
+        EEPROM_Seek(address++);
+        *data++ = EEPROM_EERDWR_R;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Writes words to the EEPROM.
+ * @param   [in] address: word address of the first word.
+ * @param   [in] data: words to be written.
+ * @param   [in] words: amount of words to write.
+ * @return  [bool] True if the words were written, false if they're out of the EEPROM or a write failed.
+ * @details Words that already hold the value aren't rewritten, to save wear.
+ */
+bool EEPROM_Write(uint32_t address, const uint32_t* data, uint32_t words)
+{
+    if (address + words > EEPROM_Size()) return false;
+
+    while (words--) {
+        EEPROM_Seek(address++);
+        if (EEPROM_EERDWR_R != *data) {
+            EEPROM_EERDWR_R = *data;
+            if (!EEPROM_Wait()) return false;
+        }
+        data++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Waits until the EEPROM is done with the current operation.
+ * @return  [bool] True if the operation went fine.
+ */
+static bool EEPROM_Wait(void)
+{
+    while (EEPROM_EEDONE_R & EEPROM_EEDONE_WORKING) ;
+
+    return !(EEPROM_EEDONE_R & EEPROM_EEDONE_ERRORS);
+}
+
+/**
+ * @brief   Points the read-write register at a word.
+ */
+static void EEPROM_Seek(uint32_t address)
+{
+    EEPROM_EEBLOCK_R = address / EEPROM_BLOCK_WORDS;
+    EEPROM_EEOFFSET_R = address % EEPROM_BLOCK_WORDS;
+}
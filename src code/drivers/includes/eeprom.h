@@ -0,0 +1,44 @@
+/**
+ * @file    eeprom.h
+ * @brief   Contains all the definitions and function prototypes
+ *          required to operate the internal EEPROM of the tiva board.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef EEPROM_H
+	#define EEPROM_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	// EEPROM Registers
+	#define EEPROM_EESIZE_R     (*((volatile unsigned long *)0x400AF000))   /// EEPROM Size Information Register
+	#define EEPROM_EEBLOCK_R    (*((volatile unsigned long *)0x400AF004))   /// EEPROM Current Block Register
+	#define EEPROM_EEOFFSET_R   (*((volatile unsigned long *)0x400AF008))   /// EEPROM Current Offset Register
+	#define EEPROM_EERDWR_R     (*((volatile unsigned long *)0x400AF010))   /// EEPROM Read-Write Register
+	#define EEPROM_EEDONE_R     (*((volatile unsigned long *)0x400AF018))   /// EEPROM Done Status Register
+	#define EEPROM_EESUPP_R     (*((volatile unsigned long *)0x400AF01C))   /// EEPROM Support Control and Status Register
+
+	#define SYSCTL_RCGCEEPROM_R (*((volatile unsigned long *)0x400FE658))   /// EEPROM Clock Gating Register
+	#define SYSCTL_PREEPROM_R   (*((volatile unsigned long *)0x400FEA58))   /// EEPROM Peripheral Ready Register
+
+	#define SYSCTL_RCGCEEPROM_R0    0x00000001  // EEPROM Module Clock Gating Control
+
+	#define EEPROM_EEDONE_WORKING   0x00000001  // EEPROM busy
+	#define EEPROM_EEDONE_NOPERM    0x00000010  // Write without permission
+	#define EEPROM_EEDONE_WRBUSY    0x00000020  // Write attempted while busy
+	#define EEPROM_EEDONE_ERRORS    (EEPROM_EEDONE_NOPERM | EEPROM_EEDONE_WRBUSY)
+	#define EEPROM_EESUPP_ERETRY    0x00000004  // Erase must be retried
+	#define EEPROM_EESUPP_PRETRY    0x00000008  // Programming must be retried
+
+	#define EEPROM_BLOCK_WORDS      16          /// 32-bit words per EEPROM block
+	#define EEPROM_WORDS_MASK       0x0000FFFF  // EESIZE word count field
+
+	bool EEPROM_Init(void);
+	uint32_t EEPROM_Size(void);
+	bool EEPROM_Read(uint32_t address, uint32_t* data, uint32_t words);
+	bool EEPROM_Write(uint32_t address, const uint32_t* data, uint32_t words);
+
+#endif // EEPROM_H
@@ -0,0 +1,33 @@
+/**
+ * @file    gpio.h
+ * @brief   Contains the register definitions required to configure GPIO port interrupts
+ *          on the tiva board.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef GPIO_H
+	#define GPIO_H
+
+	// GPIO Port Registers (AHB apertures, ports A..Q are 4KB apart, with no port I)
+	#define GPIO_PORTA_BASE     0x40058000
+	#define GPIO_PORTL_BASE     0x40062000
+	#define GPIO_REG(base, offset)  (*((volatile unsigned long *)((base) + (offset))))
+
+	#define GPIO_DATA_OFFSET(mask)  ((mask) << 2)   // Masked Data Register (only reads/writes the pins in mask)
+	#define GPIO_DIR_OFFSET         0x400   // Direction Register
+	#define GPIO_IS_OFFSET          0x404   // Interrupt Sense Register
+	#define GPIO_IBE_OFFSET         0x408   // Interrupt Both Edges Register
+	#define GPIO_IEV_OFFSET         0x40C   // Interrupt Event Register
+	#define GPIO_IM_OFFSET          0x410   // Interrupt Mask Register
+	#define GPIO_MIS_OFFSET         0x418   // Masked Interrupt Status Register
+	#define GPIO_ICR_OFFSET         0x41C   // Interrupt Clear Register
+	#define GPIO_AFSEL_OFFSET       0x420   // Alternate Function Select Register
+	#define GPIO_DEN_OFFSET         0x51C   // Digital Enable Register
+
+	#define SYSCTL_RCGCGPIO_PORTL   0x00000400  // Port L Clock Gating Control
+
+	#define INT_VEC_GPIOL           53          // GPIO Port L interrupt index (decimal)
+
+#endif // GPIO_H
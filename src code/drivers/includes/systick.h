@@ -4,7 +4,7 @@
  *          regarding the operation of the SysTick driver
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.04 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 #ifndef SYSTICK_H
@@ -56,11 +56,14 @@
 
     /**
      * @brief   SysTick driver descriptor
+     * @details tick_cb (if not NULL) is called on every tick,
+     *          after the counter has been updated.
      */
 	typedef struct systick_descriptor_ {
 	    systick_counter_t   counter;
 	    systick_countdown_t countdown;
 	    uint32_t            tick_rate;
+	    void                (*tick_cb)(void);
 	}systick_descriptor_t;
 
 	void SysTick_Init(systick_descriptor_t* descriptor);
@@ -4,7 +4,7 @@
  *          required to operate the UART0 driver for the tiva board.
  * @author  Manuel Burnay, Emad Khan (Based on his work)
  * @date    2019.09.18 (Created)
- * @date    2019.10.03 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 #ifndef UART_H
@@ -17,6 +17,7 @@
 	#define GPIO_PORTA_DEN_R    (*((volatile unsigned long *)0x4005851C))   /// GPIOA Digital Enable Register
 	#define GPIO_PORTA_PCTL_R   (*((volatile unsigned long *)0x4005852C))   /// GPIOA Port Control Register
 	#define UART0_DR_R          (*((volatile unsigned long *)0x4000C000))   /// UART0 Data Register
+	#define UART0_RSR_R         (*((volatile unsigned long *)0x4000C004))   /// UART0 Receive Status/Error Clear Register
 	#define UART0_FR_R          (*((volatile unsigned long *)0x4000C018))   /// UART0 Flag Register
 	#define UART0_IBRD_R        (*((volatile unsigned long *)0x4000C024))   /// UART0 Integer Baud-Rate Divisor Register
 	#define UART0_FBRD_R        (*((volatile unsigned long *)0x4000C028))   /// UART0 Fractional Baud-Rate Divisor Register
@@ -34,13 +35,32 @@
     #define UART_FR_BUSY            0x00000008
 	#define UART_RX_FIFO_ONE_EIGHT  0x00000038  // UART Receive FIFO Interrupt Level at >= 1/8
 	#define UART_TX_FIFO_SVN_EIGHT  0x00000007  // UART Transmit FIFO Interrupt Level at <= 7/8
+	#define UART_IFLS_RX_HALF       0x00000010  // UART Receive FIFO Interrupt Level at >= 1/2 (8 bytes)
+	#define UART_IFLS_TX_HALF       0x00000002  // UART Transmit FIFO Interrupt Level at <= 1/2 (8 bytes)
+	#define UART_IFLS_RX(level)     ((unsigned long)(level) << 3)  // RX level field, 0..4: >= 1/8, 1/4, 1/2, 3/4, 7/8 full
+	#define UART_IFLS_TX(level)     ((unsigned long)(level))       // TX level field, 0..4: <= 7/8, 3/4, 1/2, 1/4, 1/8 full
+	#define UART_IFLS_LEVEL_MAX     4
 	#define UART_LCRH_WLEN_8        0x00000060  // 8 bit word length
 	#define UART_LCRH_FEN           0x00000010  // UART Enable FIFOs
 	#define UART_CTL_UARTEN         0x00000301  // UART RX/TX Enable
 	#define UART_INT_TX             0x020       // Transmit Interrupt Mask
 	#define UART_INT_RX             0x010       // Receive Interrupt Mask
 	#define UART_INT_RT             0x040       // Receive Timeout Interrupt Mask
+	#define UART_INT_OE             0x400       // Overrun Error Interrupt Mask
+	#define UART_INT_BE             0x200       // Break Error Interrupt Mask
+	#define UART_INT_PE             0x100       // Parity Error Interrupt Mask
+	#define UART_INT_FE             0x080       // Framing Error Interrupt Mask
+	#define UART_INT_ERRORS         (UART_INT_OE | UART_INT_BE | UART_INT_PE | UART_INT_FE)
 	#define UART_CTL_EOT            0x00000010  // UART End of Transmission Enable
+	#define UART_CTL_LBE            0x00000080  // UART Loop Back Enable (TX internally fed to RX)
+	#define UART_DR_OE              0x00000800  // UART Overrun Error (received with the byte)
+	#define UART_DR_BE              0x00000400  // UART Break Error
+	#define UART_DR_PE              0x00000200  // UART Parity Error
+	#define UART_DR_FE              0x00000100  // UART Framing Error
+	#define UART_DR_ERRORS          (UART_DR_OE | UART_DR_BE | UART_DR_PE | UART_DR_FE)
+	#define UART_DR_BAD             (UART_DR_BE | UART_DR_PE | UART_DR_FE)  // the byte itself is corrupt (OE only means the next one was lost)
+
+	#define UART0_BAUD              115200      /// UART0 baud rate out of reset
 	#define EN_RX_PA0               0x00000001  // Enable Receive Function on PA0
 	#define EN_TX_PA1               0x00000002  // Enable Transmit Function on PA1
 	#define EN_DIG_PA0              0x00000001  // Enable Digital I/O on PA0
@@ -48,6 +68,8 @@
 
 	#define SYSCTL_RCGCGPIO_R      (*((volatile unsigned long *)0x400FE608)) /// GPIO Clock Gating Register
 	#define SYSCTL_RCGCUART_R      (*((volatile unsigned long *)0x400FE618)) /// UART Clock Gating Register
+	#define SYSCTL_PRGPIO_R        (*((volatile unsigned long *)0x400FEA08)) /// GPIO Peripheral Ready Register
+	#define SYSCTL_PRUART_R        (*((volatile unsigned long *)0x400FEA18)) /// UART Peripheral Ready Register
 
 	#define SYSCTL_RCGCGPIO_UART0      0x00000001  // UART0 Clock Gating Control
 	#define SYSCTL_RCGCUART_GPIOA      0x00000001  // Port A Clock Gating Control
@@ -63,6 +85,18 @@
     #define UART0_ECHO_ON     true
     #define UART0_ECHO_OFF    false
 
+    /**
+     * @brief   UART line error counters.
+     * @details overrun counts the times the RX FIFO overflowed (the byte flagged with it is still good),
+     *          the other errors count bytes that were discarded.
+     */
+	typedef struct uart_line_errors_ {
+		uint32_t    overrun;
+		uint32_t    brk;
+		uint32_t    parity;
+		uint32_t    framing;
+	} uart_line_errors_t;
+
     /**
      * @brief   UART descriptor structure
      * @details contains the rx and tx circular buffers
@@ -72,6 +106,10 @@
 		circular_buffer_t   tx;
 		circular_buffer_t   rx;
 		bool            echo;
+		uint32_t        rx_dropped;
+		uart_line_errors_t  errors;
+		uint32_t        baud;
+		void            (*tx_progress_cb)(void);
 	} uart_descriptor_t;
 
 
@@ -81,11 +119,22 @@
 
 	void UART0_IntHandler(void);    // Dunno if this should be here tbh...
 
+	bool UART0_SetEcho(bool echo_en);
+	void UART0_SetFifoLevels(uint8_t rx_level, uint8_t tx_level);
+	void UART0_SetBaud(uint32_t baud);
+	uint32_t UART0_GetBaud(void);
+	void UART0_GetLineErrors(uart_line_errors_t* errors);
+	void UART0_SetTxProgressHook(void (*hook)(void));
+
     inline bool UART0_TxReady(void);
+    bool UART0_TxIdle(void);
+    uint32_t UART0_TxFree(void);
+    uint32_t UART0_RxDropped(void);
 
     inline void UART0_putc(char c);
     uint32_t UART0_put(char* data, uint8_t length);
     void UART0_puts(char* data);
+    void UART0_write(char* data, uint32_t length);
 
     uint32_t UART0_gets(char* str, uint32_t MAX_BYTES);
 
@@ -0,0 +1,60 @@
+/**
+ * @file    uart_port.h
+ * @brief   Contains all the definitions, structures and function prototypes
+ *          required to operate the auxiliary UARTs (UART1-7) of the tiva board.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef UART_PORT_H
+	#define UART_PORT_H
+
+	#include "circular_buffer.h"
+	#include "uart.h"
+
+	// UARTn Registers (all UART modules share the same register layout, 4KB apart)
+	#define UART_BASE(n)            (0x4000C000 + ((unsigned long)(n) << 12))   /// Base address of UARTn
+	#define UART_REG(base, offset)  (*((volatile unsigned long *)((base) + (offset))))
+
+	#define UART_DR_OFFSET          0x000   // Data Register
+	#define UART_RSR_OFFSET         0x004   // Receive Status/Error Clear Register
+	#define UART_FR_OFFSET          0x018   // Flag Register
+	#define UART_IBRD_OFFSET        0x024   // Integer Baud-Rate Divisor Register
+	#define UART_FBRD_OFFSET        0x028   // Fractional Baud-Rate Divisor Register
+	#define UART_LCRH_OFFSET        0x02C   // Line Control Register
+	#define UART_CTL_OFFSET         0x030   // Control Register
+	#define UART_IFLS_OFFSET        0x034   // Interrupt FIFO Level Select Register
+	#define UART_IM_OFFSET          0x038   // Interrupt Mask Register
+	#define UART_MIS_OFFSET         0x040   // Masked Interrupt Status Register
+	#define UART_ICR_OFFSET         0x044   // Interrupt Clear Register
+
+	#define UART_IFLS_RX_ONE_EIGHT  0x00000000  // UART Receive FIFO Interrupt Level at >= 1/8 (2 bytes)
+
+	/**
+	 * @brief   Auxiliary UART port descriptor.
+	 * @details If rx_cb is set, received bytes are handed to it straight from the interrupt handler
+	 *          instead of being queued in the rx buffer.
+	 * @details Line errors (overrun, break, parity, framing) are counted in rx_errors,
+	 *          and the corrupt bytes (all but overruns) are discarded.
+	 */
+	typedef struct uart_port_ {
+	    unsigned long       base;
+	    circular_buffer_t   tx;
+	    circular_buffer_t   rx;
+	    void                (*rx_cb)(struct uart_port_* port, char c);
+	    uint32_t            rx_dropped;
+	    uint32_t            rx_errors;
+	} uart_port_t;
+
+	void UARTPort_Init(uart_port_t* port, uint8_t uart_num, uint32_t baud);
+	void UARTPort_SetBaud(uart_port_t* port, uint32_t baud);
+	void UARTPort_Disable(uart_port_t* port);
+	void UARTPort_SetLoopback(uart_port_t* port, bool loopback_en);
+
+	void UARTPort_IntHandler(uart_port_t* port);
+
+	void UARTPort_TxFill(uart_port_t* port);
+	uint32_t UARTPort_put(uart_port_t* port, char* data, uint32_t length);
+
+#endif // UART_PORT_H
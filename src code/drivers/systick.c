@@ -3,12 +3,14 @@
  * @brief   Contains all functionality of the SysTick driver.
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.04 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "SysTick.h"
+#include "isr_stats.h"
 
 
 systick_descriptor_t* sys;
@@ -97,6 +99,7 @@ void SysTick_Stop(void)
  *          - Increments the counter value
  *              - If comparison is enable it'll compare with the cmp value,
  *                  - If they are equal, it'll reset the counter and call the callback function.
+ *          - Calls the tick callback if there is one.
  *          - Decrements the countdown value if enabled
  *              - If the value is 0, it'll disable the countdown and call the callback function.
  * @details	As this is the interrupt handler for SysTick, 
@@ -110,6 +113,8 @@ void SysTick_Stop(void)
  */
 void SysTick_IntHandler(void)
 {
+    ISR_STATS_ENTER();
+
     sys->counter.value++;
 
     if (sys->counter.cmp_en && (sys->counter.value == sys->counter.cmp)) {
@@ -117,6 +122,10 @@ void SysTick_IntHandler(void)
         sys->counter.value = 0;
     }
 
+    if (sys->tick_cb != NULL) {
+        sys->tick_cb();
+    }
+
     if (sys->countdown.en) {
         sys->countdown.value--;
 
@@ -125,4 +134,6 @@ void SysTick_IntHandler(void)
             sys->countdown.en = false;
         }
     }
+
+    ISR_STATS_EXIT(ISR_SYSTICK);
 }
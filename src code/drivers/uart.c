@@ -3,14 +3,19 @@
  * @brief   Contains functionality to operate the UART0 driver for the tiva board.
  * @author  Manuel Burnay, Emad Khan (Based on his work)
  * @date    2019.09.18 (Created)
- * @date    2019.10.04 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 #include <string.h>
+#include "cpu.h"
 #include "uart.h"
+#include "isr_stats.h"
 
 static uart_descriptor_t* UART0;
 
+static void UART0_TxFill(void);
+static void UART0_LineError(unsigned long data);
+
 /**
  * @brief   Initializes the control registers for UART0 and the UART descriptor
  *          that is accessed by the driver.
@@ -22,36 +27,41 @@ static uart_descriptor_t* UART0;
  */
 void UART0_Init(uart_descriptor_t* descriptor)
 {
-    volatile int wait;
-
     /* Initialize UART0 */
     SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCUART_GPIOA;   // Enable Clock Gating for UART0
     SYSCTL_RCGCUART_R |= SYSCTL_RCGCGPIO_UART0;   // Enable Clock Gating for PORTA
-    wait = 0; // give time for the clocks to activate
 
+    // Poll the peripheral ready registers instead of guessing how long the clocks take to activate
+    while (!(SYSCTL_PRGPIO_R & SYSCTL_RCGCUART_GPIOA)) ;
+    while (!(SYSCTL_PRUART_R & SYSCTL_RCGCGPIO_UART0)) ;
+
+    while (UART0_FR_R & UART_FR_BUSY) ;     // let any character in flight finish before reconfiguring
     UART0_CTL_R &= ~UART_CTL_UARTEN;        // Disable the UART
-    wait = 0;   // wait required before accessing the UART config regs
 
     // Setup the BAUD rate
     UART0_IBRD_R = 8;   // IBRD = int(16,000,000 / (16 * 115,200)) = 8.680555555555556
     UART0_FBRD_R = 44;  // FBRD = int(.680555555555556 * 64 + 0.5) = 44.05555555555556
 
-    UART0_LCRH_R = (UART_LCRH_WLEN_8);  // WLEN: 8, no parity, one stop bit, without FIFOs)
+    UART0_LCRH_R = (UART_LCRH_WLEN_8 | UART_LCRH_FEN);  // WLEN: 8, no parity, one stop bit, with FIFOs
+    UART0_IFLS_R = (UART_IFLS_RX_HALF | UART_IFLS_TX_HALF); // Interrupt on half-full RX / half-empty TX FIFOs
 
     GPIO_PORTA_AFSEL_R = 0x3;        // Enable Receive and Transmit on PA1-0
     GPIO_PORTA_PCTL_R = (0x01) | ((0x01) << 4);         // Enable UART RX/TX pins on PA1-0
     GPIO_PORTA_DEN_R = EN_DIG_PA0 | EN_DIG_PA1;        // Enable Digital I/O on PA1-0
 
     UART0_CTL_R = UART_CTL_UARTEN;        // Enable the UART
-    wait = 0; // wait; give UART time to enable itself.
 
     UART0 = descriptor;
 
     circular_buffer_init(&UART0->tx);
     circular_buffer_init(&UART0->rx);
+    UART0->rx_dropped = 0;
+    memset(&UART0->errors, 0, sizeof(UART0->errors));
+    UART0->baud = UART0_BAUD;
+    UART0->tx_progress_cb = NULL;
 
     UART0_InterruptEnable(INT_VEC_UART0);       // Enable UART0 interrupts
-    UART0_IntEnable(UART_INT_RX | UART_INT_TX); // Enable Receive and Transmit interrupts
+    UART0_IntEnable(UART_INT_RX | UART_INT_RT | UART_INT_TX | UART_INT_ERRORS); // Enable Receive, Receive Timeout, Transmit and line error interrupts
 }
 
 /**
@@ -97,14 +107,30 @@ void UART0_IntEnable(unsigned long flags)
  */
 void UART0_IntHandler(void)
 {
-    if (UART0_MIS_R & UART_INT_RX) {
-        /* RECV done - clear interrupt and make char available to application */
-        UART0_ICR_R |= UART_INT_RX;
+    char c;
+    unsigned long data;
+    ISR_STATS_ENTER();
+
+    if (UART0_MIS_R & (UART_INT_RX | UART_INT_RT | UART_INT_ERRORS)) {
+        /* RECV done - clear interrupt and drain the RX FIFO to the application */
+        UART0_ICR_R |= (UART_INT_RX | UART_INT_RT | UART_INT_ERRORS);
 
-        enqueuec(&UART0->rx, UART0_DR_R);
+        while (!(UART0_FR_R & UART_FR_RXFE)) {
+            data = UART0_DR_R;  // reading DR pops the FIFO, so only read it once per byte.
 
-        if (UART0->echo) {
-            enqueuec(&UART0->tx, UART0_DR_R);
+            if (data & UART_DR_ERRORS) {
+                UART0_LineError(data);
+                if (data & UART_DR_BAD) continue;   // never let a corrupt byte reach the query buffer
+            }
+
+            c = data;
+            if (!enqueuec_s(&UART0->rx, c, false)) {
+                UART0->rx_dropped++;
+            }
+
+            if (UART0->echo) {
+                enqueuec_s(&UART0->tx, c, false);
+            }
         }
     }
 
@@ -113,8 +139,47 @@ void UART0_IntHandler(void)
         UART0_ICR_R |= UART_INT_TX;
     }
 
-    if (buffer_size(&UART0->tx) != BUFFER_EMPTY) {
-        UART0_putc(dequeuec(&UART0->tx));
+    UART0_TxFill();
+
+    ISR_STATS_EXIT(ISR_UART0);
+}
+
+/**
+ * @brief   Sets the driver-level RX echo configuration.
+ * @param   [in] echo_en: True to echo every received byte back, false to receive silently.
+ * @return  [bool] The echo configuration prior to this call, so it can be restored later.
+ */
+bool UART0_SetEcho(bool echo_en)
+{
+    bool prev = UART0->echo;
+    UART0->echo = echo_en;
+
+    return prev;
+}
+
+/**
+ * @brief   Sets the FIFO levels the RX and TX interrupts trigger at.
+ * @param   [in] rx_level: RX level, 0..4 (>= 1/8, 1/4, 1/2, 3/4, 7/8 full). Higher levels mean fewer interrupts,
+ *          the receive timeout interrupt still picks up whatever is left under the level.
+ * @param   [in] tx_level: TX level, 0..4 (<= 7/8, 3/4, 1/2, 1/4, 1/8 full). Lower levels mean fewer interrupts,
+ *          but less time to top up the FIFO before it runs dry.
+ * @details Takes effect right away, it's a single register write.
+ */
+void UART0_SetFifoLevels(uint8_t rx_level, uint8_t tx_level)
+{
+    UART0_IFLS_R = UART_IFLS_RX(rx_level) | UART_IFLS_TX(tx_level);
+}
+
+/**
+ * @brief   Moves queued TX bytes into the TX FIFO until either one runs out.
+ * @details Must be called with UART0 interrupts unable to preempt it
+ *          (i.e. from the interrupt handler or with interrupts disabled),
+ *          since both contexts dequeue from the TX buffer.
+ */
+static void UART0_TxFill(void)
+{
+    while (buffer_size(&UART0->tx) != BUFFER_EMPTY && !(UART0_FR_R & UART_FR_TXFF)) {
+        UART0_DR_R = dequeuec(&UART0->tx);
     }
 }
 
@@ -140,6 +205,99 @@ inline bool UART0_TxReady(void)
     return !(UART0_FR_R & UART_FR_BUSY);
 }
 
+/**
+ * @brief   Determines if UART 0 has sent everything that was queued to it.
+ * @return  [bool] True if both the TX buffer and the TX FIFO/shift register are empty.
+ */
+bool UART0_TxIdle(void)
+{
+    return (buffer_size(&UART0->tx) == BUFFER_EMPTY) && UART0_TxReady();
+}
+
+/**
+ * @brief   Gets the amount of bytes that can currently be queued to UART 0 without truncation.
+ * @return  [uint32_t] Free space in the TX buffer.
+ */
+uint32_t UART0_TxFree(void)
+{
+    return CIRCULAR_BUFFER_MASK - buffer_size(&UART0->tx);
+}
+
+/**
+ * @brief   Counts the line errors flagged with a received byte.
+ * @param   [in] data: data register value the byte was read with.
+ */
+static void UART0_LineError(unsigned long data)
+{
+    if (data & UART_DR_OE) UART0->errors.overrun++;
+    if (data & UART_DR_BE) UART0->errors.brk++;
+    if (data & UART_DR_PE) UART0->errors.parity++;
+    if (data & UART_DR_FE) UART0->errors.framing++;
+
+    UART0_RSR_R = 0;    // clear the sticky error flags
+}
+
+/**
+ * @brief   Changes the UART0 baud rate.
+ * @param   [in] baud: new baud rate.
+ * @details Anything still in the TX FIFO is sent at the old rate first (BUSY is waited on
+ *          while the UART is still enabled, a disabled UART never drains its FIFO),
+ *          but the TX buffer isn't waited on: call this with interrupts masked, right after checking
+ *          UART0_TxIdle(), so nothing can be queued (and pushed into the FIFO) in between.
+ *          The divisor is F_CPU_CLK / (16 * baud), in 6-bit fixed point (rounded).
+ */
+void UART0_SetBaud(uint32_t baud)
+{
+    uint32_t div = ((F_CPU_CLK * 8) / baud + 1) / 2;
+
+    while (UART0_FR_R & UART_FR_BUSY) ;
+    UART0_CTL_R &= ~UART_CTL_UARTEN;
+
+    UART0_IBRD_R = div >> 6;
+    UART0_FBRD_R = div & 0x3F;
+    UART0_LCRH_R = UART0_LCRH_R;    // the divisors are latched by a LCRH write
+
+    UART0_CTL_R = UART_CTL_UARTEN;
+    UART0->baud = baud;
+}
+
+/**
+ * @brief   Gets the current UART0 baud rate.
+ */
+uint32_t UART0_GetBaud(void)
+{
+    return UART0->baud;
+}
+
+/**
+ * @brief   Takes a consistent copy of the UART0 line error counters.
+ * @param   [out] errors: where the counters are copied to.
+ */
+void UART0_GetLineErrors(uart_line_errors_t* errors)
+{
+    uint32_t primask = IRQ_SAVE();
+    *errors = UART0->errors;
+    IRQ_RESTORE(primask);
+}
+
+/**
+ * @brief   Gets the amount of received bytes dropped because the RX buffer was full.
+ */
+uint32_t UART0_RxDropped(void)
+{
+    return UART0->rx_dropped;
+}
+
+/**
+ * @brief   Sets the TX progress hook.
+ * @param   [in] hook: function called whenever UART0_write() queues more bytes, NULL for none.
+ *          It can run in interrupt context (systime callbacks write to the console too), so keep it short.
+ */
+void UART0_SetTxProgressHook(void (*hook)(void))
+{
+    UART0->tx_progress_cb = hook;
+}
+
 /**
  * @brief   Sends char string to UART 0.
  * @details This function will block if at the time of call,
@@ -148,8 +306,24 @@ inline bool UART0_TxReady(void)
  */
 void UART0_puts(char* str)
 {
-    uint32_t length = strlen(str);
+    UART0_write(str, strlen(str));
+}
+
+/**
+ * @brief   Sends a byte stream of any length to UART 0.
+ * @param   [in] data: pointer to the bytes to be sent (they may include null bytes).
+ * @param   [in] length: amount of bytes to be sent.
+ * @details Same as UART0_puts(), it blocks until the whole stream has been queued to send.
+ * @details The TX progress hook (if any) is called every time more of the stream is queued,
+ *          so a long write at a low baud rate still shows the caller is making progress.
+ * @details While the buffer is full, the TX FIFO is topped up from here:
+ *          callers running at the UART interrupt's priority or above (systime callbacks, like the alarm)
+ *          keep the TX interrupt from doing it, and would otherwise wait forever.
+ */
+void UART0_write(char* data, uint32_t length)
+{
     uint32_t bytes_sent = 0;
+    uint32_t chunk, primask;
 
     while (bytes_sent != length) {
         /*
@@ -157,8 +331,18 @@ void UART0_puts(char* str)
          * doing so might be worst for code progression than to only call it once there is room
          * to queue more characters from the string.
          */
-        if (buffer_size(&UART0->tx) != BUFFER_FULL) 
-            bytes_sent += UART0_put(str+bytes_sent, length-bytes_sent);
+        if (buffer_size(&UART0->tx) != BUFFER_FULL) {
+            chunk = length - bytes_sent;
+            if (chunk > CIRCULAR_BUFFER_MASK) chunk = CIRCULAR_BUFFER_MASK;   // UART0_put takes an 8-bit length
+
+            bytes_sent += UART0_put(data+bytes_sent, chunk);
+            if (UART0->tx_progress_cb != NULL) UART0->tx_progress_cb();
+        }
+        else {
+            primask = IRQ_SAVE();
+            UART0_TxFill();
+            IRQ_RESTORE(primask);
+        }
     }
 }
 
@@ -169,12 +353,19 @@ void UART0_puts(char* str)
  * @return  [uint32_t] Returns amount of bytes successfully sent to UART 0.
  * @details This function does not guarantee that all bytes in the string are sent.
  *          if there isn't enough space in the TX buffer, the byte stream is truncated.
+ * @details The TX FIFO is topped up right away, so this never waits on the peripheral;
+ *          the TX interrupt takes care of the rest of the queued bytes.
+ * @details The interrupt mask is restored (not just cleared) afterwards,
+ *          so it's safe from interrupt handlers and inside other critical sections.
  */
 uint32_t UART0_put(char* data, uint8_t length)
 {
-    uint8_t bytes_sent = enqueue(&UART0->tx, data, length);
+    uint8_t bytes_sent;
+    uint32_t primask = IRQ_SAVE();
 
-    UART0_putc(dequeuec(&UART0->tx));
+    bytes_sent = enqueue(&UART0->tx, data, length);
+    UART0_TxFill();
+    IRQ_RESTORE(primask);
 
     return bytes_sent;
 }
@@ -0,0 +1,162 @@
+/**
+ * @file    uart_port.c
+ * @brief   Contains functionality to operate the auxiliary UARTs (UART1-7) of the tiva board.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Same model as the UART0 driver (FIFOs enabled, interrupt driven, circular buffers),
+ *          but addressed through a port descriptor so several UARTs can be run at once.
+ *          Pin muxing is left to the user of the port, since it depends on the board.
+ */
+
+#include "cpu.h"
+#include "uart_port.h"
+
+/**
+ * @brief   Initializes an auxiliary UART and its port descriptor.
+ * @param   [out] port: port descriptor to be initialized.
+ * @param   [in] uart_num: UART module number (1..7).
+ * @param   [in] baud: baud rate, 8 data bits, no parity, 1 stop bit.
+ * @details The port's interrupt handler must be registered in the vector table
+ *          and call UARTPort_IntHandler() with this port,
+ *          the NVIC interrupt itself is enabled by the caller.
+ */
+void UARTPort_Init(uart_port_t* port, uint8_t uart_num, uint32_t baud)
+{
+    port->base = UART_BASE(uart_num);
+    port->rx_dropped = 0;
+    port->rx_errors = 0;
+
+    circular_buffer_init(&port->tx);
+    circular_buffer_init(&port->rx);
+
+    SYSCTL_RCGCUART_R |= (1 << uart_num);           // Enable Clock Gating for the UART
+    while (!(SYSCTL_PRUART_R & (1 << uart_num))) ;  // Wait until it's ready to be accessed
+
+    UART_REG(port->base, UART_CTL_OFFSET) &= ~UART_CTL_UARTEN;     // Disable the UART
+
+    UARTPort_SetBaud(port, baud);
+
+    UART_REG(port->base, UART_LCRH_OFFSET) = (UART_LCRH_WLEN_8 | UART_LCRH_FEN);
+    UART_REG(port->base, UART_IFLS_OFFSET) = (UART_IFLS_RX_ONE_EIGHT | UART_IFLS_TX_HALF);
+
+    UART_REG(port->base, UART_CTL_OFFSET) = UART_CTL_UARTEN;    // Enable the UART
+    UART_REG(port->base, UART_IM_OFFSET) = (UART_INT_RX | UART_INT_RT | UART_INT_TX);
+}
+
+/**
+ * @brief   Sets the baud rate of a port.
+ * @param   [in] port: port descriptor.
+ * @param   [in] baud: new baud rate.
+ * @details The divisor is F_CPU_CLK / (16 * baud), in 6-bit fixed point (rounded).
+ *          LCRH is rewritten afterwards, as required for the divisor to be latched.
+ * @details The UART must be disabled (and idle) while the divisors change, as UARTPort_Init() does.
+ */
+void UARTPort_SetBaud(uart_port_t* port, uint32_t baud)
+{
+    uint32_t div = ((F_CPU_CLK * 8) / baud + 1) / 2;
+
+    UART_REG(port->base, UART_IBRD_OFFSET) = div >> 6;
+    UART_REG(port->base, UART_FBRD_OFFSET) = div & 0x3F;
+    UART_REG(port->base, UART_LCRH_OFFSET) = UART_REG(port->base, UART_LCRH_OFFSET);
+}
+
+/**
+ * @brief   Disables a port's UART and its interrupts.
+ * @param   [in] port: port descriptor.
+ */
+void UARTPort_Disable(uart_port_t* port)
+{
+    UART_REG(port->base, UART_IM_OFFSET) = 0;
+    UART_REG(port->base, UART_CTL_OFFSET) &= ~UART_CTL_UARTEN;
+}
+
+/**
+ * @brief   Sets a port's internal loopback (the UART's TX is fed straight into its own RX, the pins aren't used).
+ * @param   [in] port: port descriptor.
+ * @param   [in] loopback_en: True to enable the loopback, false to go back to the pins.
+ * @details The UART is disabled (once its transmitter is done) while the mode changes,
+ *          and anything received in the old mode is flushed.
+ */
+void UARTPort_SetLoopback(uart_port_t* port, bool loopback_en)
+{
+    unsigned long ctl = UART_REG(port->base, UART_CTL_OFFSET);
+
+    while (UART_REG(port->base, UART_FR_OFFSET) & UART_FR_BUSY) ;
+    UART_REG(port->base, UART_CTL_OFFSET) = ctl & ~UART_CTL_UARTEN;
+
+    ctl = loopback_en ? (ctl | UART_CTL_LBE) : (ctl & ~UART_CTL_LBE);
+    UART_REG(port->base, UART_CTL_OFFSET) = ctl;
+
+    while (!(UART_REG(port->base, UART_FR_OFFSET) & UART_FR_RXFE)) {
+        (void)UART_REG(port->base, UART_DR_OFFSET);
+    }
+    UART_REG(port->base, UART_RSR_OFFSET) = 0;  // clear the error flags
+}
+
+/**
+ * @brief   Shared interrupt handler body for the auxiliary UARTs.
+ * @param   [in, out] port: port descriptor of the UART that interrupted.
+ * @details Drains the whole RX FIFO (to rx_cb, or the rx buffer) and tops up the TX FIFO.
+ *          Bytes with a line error are dropped here (the error flags come with each byte in DR),
+ *          apart from overruns, where the flagged byte is fine and it's the next one that was lost.
+ */
+void UARTPort_IntHandler(uart_port_t* port)
+{
+    char c;
+    unsigned long data;
+    unsigned long status = UART_REG(port->base, UART_MIS_OFFSET);
+
+    UART_REG(port->base, UART_ICR_OFFSET) = status;
+
+    while (!(UART_REG(port->base, UART_FR_OFFSET) & UART_FR_RXFE)) {
+        data = UART_REG(port->base, UART_DR_OFFSET);
+        if (data & UART_DR_ERRORS) {
+            port->rx_errors++;
+            if (data & UART_DR_BAD) continue;
+        }
+        c = data;
+
+        if (port->rx_cb != NULL) {
+            port->rx_cb(port, c);
+        }
+        else if (!enqueuec_s(&port->rx, c, false)) {
+            port->rx_dropped++;
+        }
+    }
+
+    UARTPort_TxFill(port);
+}
+
+/**
+ * @brief   Moves queued TX bytes into the port's TX FIFO until either one runs out.
+ * @param   [in, out] port: port descriptor.
+ * @details Must not be preempted by the port's interrupt handler.
+ */
+void UARTPort_TxFill(uart_port_t* port)
+{
+    while (buffer_size(&port->tx) != BUFFER_EMPTY &&
+           !(UART_REG(port->base, UART_FR_OFFSET) & UART_FR_TXFF)) {
+        UART_REG(port->base, UART_DR_OFFSET) = dequeuec(&port->tx);
+    }
+}
+
+/**
+ * @brief   Sends a byte stream through a port.
+ * @param   [in, out] port: port descriptor.
+ * @param   [in] data: bytes to be sent.
+ * @param   [in] length: amount of bytes to be sent.
+ * @return  [uint32_t] Amount of bytes queued (truncated if the TX buffer doesn't have the space).
+ */
+uint32_t UARTPort_put(uart_port_t* port, char* data, uint32_t length)
+{
+    uint32_t bytes_sent;
+    uint32_t primask = IRQ_SAVE();
+
+    bytes_sent = enqueue(&port->tx, data, length);
+    UARTPort_TxFill(port);
+    IRQ_RESTORE(primask);
+
+    return bytes_sent;
+}
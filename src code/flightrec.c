@@ -0,0 +1,334 @@
+
+/**
+ * @file    flightrec.c
+ * @brief   Flight recorder: a trace of the last events, plus counters and the console buffers, that survives resets.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details The recorder lives in no-init RAM (see CPU_NOINIT), which keeps its contents through any reset
+ *          but a power-on or brown-out one. On boot, a recorder left by the previous run (right magic)
+ *          is moved aside for the postmortem query, and a new one is started.
+ * @details Trace records are written as things happen, the rest (exception state, counters, buffers)
+ *          is only filled in when the recorder is sealed, together with the CRC:
+ *          - by the watchdog, when the main loop hasn't gone around for FLIGHTREC_WDT_TIMEOUT seconds.
+ *            Its first time-out is an NMI, which preempts anything (a spinning interrupt handler included),
+ *            and the second one resets the board,
+ *          - by "postmortem reboot".
+ *          The watchdog is fed from a systime tick hook, but only if the main loop has checked in since the last tick,
+ *          so it catches both a stuck main loop and a stuck interrupt handler (ticks stop too).
+ * @details FlightRec_NmiHandler must be registered in the NMI slot of the vector table.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include "flightrec.h"
+#include "query_handler.h"
+#include "systime.h"
+#include "crc32.h"
+
+#define FLIGHTREC_CRC_LENGTH    (offsetof(flightrec_t, crc))
+
+static const char* const EVENT_NAMES[FLIGHTREC_EVENT_COUNT] = {
+    "BOOT", "QUERY", "QUERY_END", "ALARM_IN", "ALARM_OUT", "BAUD", "WATCHDOG"
+};
+
+static const char* const SEAL_NAMES[] = {"none", "watchdog", "reboot"};
+
+/** Reset cause bits, lowest first */
+static const char* const RESET_NAMES[] = {"EXT", "POR", "BOR", "WDT0", "SW"};
+
+#define RESET_NAME_COUNT    (sizeof(RESET_NAMES)/sizeof(RESET_NAMES[0]))
+
+static flightrec_t recorder CPU_NOINIT;     /** Recorder of the current run */
+static flightrec_t previous;                /** Recorder left by the previous run */
+static bool previous_valid;
+static bool previous_sealed;
+static uint32_t reset_cause;                /** Why the previous run ended */
+static uart_descriptor_t* console;
+static volatile bool alive;
+
+static void FlightRec_Record(uint8_t event, uint8_t arg, uint16_t data);
+static void FlightRec_Seal(uint32_t seal);
+static void FlightRec_WatchdogStart(void);
+static void FlightRec_Dump(void);
+static void FlightRec_DumpBuffer(const char* name, const circular_buffer_t* buffer);
+
+/**
+ * @brief   Picks up the previous run's recorder (if there's one), and starts recording this run.
+ * @param   [in] uart: UART0 descriptor, its counters and buffers are copied when sealing.
+ * @details Make sure systime has been initialized prior to calling this function,
+ *          the watchdog is fed by a systime tick hook. The watchdog starts right away.
+ * @details Console writes that wait for TX buffer room count as main loop passes (see FLIGHTREC_WDT_TIMEOUT).
+ */
+void FlightRec_Init(uart_descriptor_t* uart)
+{
+    console = uart;
+
+    reset_cause = SYSCTL_RESC_R;
+    SYSCTL_RESC_R = 0;  // so the next boot only sees its own reset
+
+    previous_valid = (recorder.magic == FLIGHTREC_MAGIC) && !(reset_cause & SYSCTL_RESC_POWER);
+    previous_sealed = false;
+
+    if (previous_valid) {
+        previous = recorder;
+        previous_sealed = (previous.seal != FLIGHTREC_UNSEALED) &&
+                          (crc32(&previous, FLIGHTREC_CRC_LENGTH) == previous.crc);
+    }
+
+    memset(&recorder, 0, sizeof(recorder));
+    recorder.magic = FLIGHTREC_MAGIC;
+    recorder.boots = previous_valid ? previous.boots + 1 : 0;
+
+    FlightRec_Trace(FLIGHTREC_BOOT, reset_cause, recorder.boots);
+
+    alive = true;
+    systime_AddTickHook(FlightRec_Tick);
+    UART0_SetTxProgressHook(FlightRec_Update);  // long console writes are progress too
+    FlightRec_WatchdogStart();
+}
+
+/**
+ * @brief   Adds a record to the trace.
+ * @param   [in] event: trace event (see FLIGHTREC_EVENTS).
+ * @param   [in] arg, data: event details.
+ * @details Safe to call from interrupt handlers.
+ */
+void FlightRec_Trace(uint8_t event, uint8_t arg, uint16_t data)
+{
+    uint32_t primask = IRQ_SAVE();
+    FlightRec_Record(event, arg, data);
+    IRQ_RESTORE(primask);
+}
+
+/**
+ * @brief   Services the postmortem query.
+ * @param   [in] args: query set data (NULL if there is none). Supported forms:
+ *          - (none):   dump the previous run's recorder,
+ *          - CLEAR:    forget the previous run's recorder,
+ *          - REBOOT:   seal this run's recorder and reset the board.
+ * @return  [bool] True if the arguments were valid.
+ */
+bool FlightRec_Query(char* args)
+{
+    if (args == NULL) {
+        FlightRec_Dump();
+    }
+    else if (strcmp(args, "CLEAR") == 0) {
+        previous_valid = false;
+    }
+    else if (strcmp(args, "REBOOT") == 0) {
+        UART0_puts("Rebooting\n");
+        while (!UART0_TxIdle()) ;
+
+        DISABLE_IRQ();
+        FlightRec_Seal(FLIGHTREC_SEAL_REBOOT);
+        CPU_RESET();
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Flight recorder update function, call it on every main loop pass.
+ * @details Lets the next tick feed the watchdog. Also the UART0 TX progress hook.
+ */
+void FlightRec_Update(void)
+{
+    alive = true;
+}
+
+/**
+ * @brief   Flight recorder tick hook: keeps the uptime, and feeds the watchdog if the main loop is going around.
+ */
+void FlightRec_Tick(void)
+{
+    recorder.ticks++;
+
+    if (alive) {
+        WDT0_ICR_R = 1;     // reload
+        alive = false;
+    }
+}
+
+/**
+ * @brief   Sets how long the main loop can go without a pass before the watchdog seals the recorder.
+ * @param   [in] seconds: watchdog time-out, the reset comes as long again after it (at most 268 seconds).
+ * @details Loading the counter also restarts the count.
+ */
+void FlightRec_SetTimeout(uint32_t seconds)
+{
+    WDT0_LOAD_R = seconds * F_CPU_CLK;
+}
+
+/**
+ * @brief   Watchdog first time-out (NMI) handler: seals the recorder and waits for the reset.
+ * @details Nothing else runs from here on, the second time-out resets the board FLIGHTREC_WDT_TIMEOUT seconds later.
+ */
+void FlightRec_NmiHandler(void)
+{
+    FlightRec_Record(FLIGHTREC_WATCHDOG, 0, 0);
+    FlightRec_Seal(FLIGHTREC_SEAL_WATCHDOG);
+
+    while (1) ;
+}
+
+/**
+ * @brief   Adds a record to the trace, must not be preempted by anything else that traces.
+ */
+static void FlightRec_Record(uint8_t event, uint8_t arg, uint16_t data)
+{
+    flightrec_trace_t* record = &recorder.trace[recorder.trace_count % FLIGHTREC_TRACE_RECORDS];
+
+    record->ticks = recorder.ticks;
+    record->event = event;
+    record->arg = arg;
+    record->data = data;
+
+    recorder.trace_count++;
+}
+
+/**
+ * @brief   Takes the snapshot of the exception state, counters and console buffers, and computes the CRC.
+ * @param   [in] seal: why the recorder is sealed (see FLIGHTREC_SEALS).
+ * @details Runs from the NMI as well, so it reads everything straight away (no interrupt masking).
+ */
+static void FlightRec_Seal(uint32_t seal)
+{
+    uint8_t i;
+
+    recorder.seal = seal;
+    recorder.shcsr = CPU_SHCSR_R;
+    recorder.active[0] = CPU_NVIC_ACTIVE0_R;
+    recorder.active[1] = CPU_NVIC_ACTIVE1_R;
+
+    for (i = 0; i < ISR_COUNT; i++) {
+        recorder.counters.isr_calls[i] = isr_stats[i].count;
+    }
+    recorder.counters.rx_dropped = console->rx_dropped;
+    recorder.counters.errors = console->errors;
+    recorder.counters.baud = console->baud;
+
+    recorder.rx = console->rx;
+    recorder.tx = console->tx;
+
+    recorder.crc = crc32(&recorder, FLIGHTREC_CRC_LENGTH);
+}
+
+/**
+ * @brief   Starts watchdog 0: an NMI on the first time-out, a reset on the second.
+ */
+static void FlightRec_WatchdogStart(void)
+{
+    SYSCTL_RCGCWD_R |= SYSCTL_RCGCWD_WDT0;
+    while (!(SYSCTL_PRWD_R & SYSCTL_RCGCWD_WDT0)) ;
+
+    FlightRec_SetTimeout(FLIGHTREC_WDT_TIMEOUT);
+    WDT0_TEST_R |= WDT_TEST_STALL;
+    WDT0_CTL_R = WDT_CTL_RESEN | WDT_CTL_INTTYPE_NMI;   // the interrupt type has to be set before enabling it
+    WDT0_CTL_R |= WDT_CTL_INTEN;
+}
+
+/**
+ * @brief   Dumps the previous run's recorder.
+ * @details #POSTMORTEM <SEALED|UNSEALED|NONE> block with the run summary and the trace (oldest first),
+ *          and for sealed recorders the exception state, counters and console buffers (hex).
+ */
+static void FlightRec_Dump(void)
+{
+    char dump_str[96];  // one row at a time, fixed headers go out on their own
+    const flightrec_trace_t* record;
+    const char* arg_str;
+    uint32_t i, count;
+    uint8_t bit;
+
+    if (!previous_valid) {
+        UART0_puts("#POSTMORTEM NONE\n#END\n");
+        return;
+    }
+
+    sprintf(dump_str, "#POSTMORTEM %s\nboots,reset,seal,uptime_ticks\n%u,",
+            previous_sealed ? "SEALED" : "UNSEALED", previous.boots);
+    UART0_puts(dump_str);
+
+    for (bit = 0, count = 0; bit < RESET_NAME_COUNT; bit++) {
+        if (reset_cause & (1 << bit)) {
+            if (count++) UART0_puts("|");
+            UART0_puts((char*)RESET_NAMES[bit]);
+        }
+    }
+
+    sprintf(dump_str, ",%s,%u\nticks,event,arg,data\n",
+            previous_sealed ? SEAL_NAMES[previous.seal] : SEAL_NAMES[FLIGHTREC_UNSEALED], previous.ticks);
+    UART0_puts(dump_str);
+
+    count = (previous.trace_count < FLIGHTREC_TRACE_RECORDS) ? previous.trace_count : FLIGHTREC_TRACE_RECORDS;
+    for (i = previous.trace_count - count; i != previous.trace_count; i++) {
+        record = &previous.trace[i % FLIGHTREC_TRACE_RECORDS];
+
+        arg_str = NULL;
+        if (record->event == FLIGHTREC_QUERY || record->event == FLIGHTREC_QUERY_END) {
+            arg_str = QueryKeyword(record->arg);
+        }
+
+        if (arg_str != NULL) {
+            sprintf(dump_str, "%u,%s,%s,%u\n", record->ticks, EVENT_NAMES[record->event], arg_str, record->data);
+        }
+        else {
+            sprintf(dump_str, "%u,%s,%u,%u\n", record->ticks,
+                    (record->event < FLIGHTREC_EVENT_COUNT) ? EVENT_NAMES[record->event] : "?",
+                    record->arg, record->data);
+        }
+        UART0_puts(dump_str);
+    }
+
+    if (previous_sealed) {
+        UART0_puts("shcsr,active0,active1\n");
+        sprintf(dump_str, "0x%08X,0x%08X,0x%08X\n", previous.shcsr, previous.active[0], previous.active[1]);
+        UART0_puts(dump_str);
+
+        UART0_puts("isr,calls\n");
+
+        for (i = 0; i < ISR_COUNT; i++) {
+            sprintf(dump_str, "%s,%u\n", ISR_NAMES[i], previous.counters.isr_calls[i]);
+            UART0_puts(dump_str);
+        }
+
+        UART0_puts("rx_dropped,overrun,break,parity,framing,baud\n");
+        sprintf(dump_str, "%u,%u,%u,%u,%u,%u\n",
+                previous.counters.rx_dropped, previous.counters.errors.overrun, previous.counters.errors.brk,
+                previous.counters.errors.parity, previous.counters.errors.framing, previous.counters.baud);
+        UART0_puts(dump_str);
+
+        UART0_puts("buffer,rd_ptr,wr_ptr,data\n");
+        FlightRec_DumpBuffer("rx", &previous.rx);
+        FlightRec_DumpBuffer("tx", &previous.tx);
+    }
+
+    UART0_puts("#END\n");
+}
+
+/**
+ * @brief   Dumps a copy of a console buffer as a CSV row, the data in hex.
+ */
+static void FlightRec_DumpBuffer(const char* name, const circular_buffer_t* buffer)
+{
+    char hex_str[65];
+    uint32_t i, j;
+
+    sprintf(hex_str, "%s,%u,%u,", name, buffer->rd_ptr & CIRCULAR_BUFFER_MASK, buffer->wr_ptr & CIRCULAR_BUFFER_MASK);
+    UART0_puts(hex_str);
+
+    for (i = 0; i < CIRCULAR_BUFFER_SIZE; i += 32) {
+        for (j = 0; j < 32; j++) {
+            sprintf(hex_str + j*2, "%02X", (uint8_t)buffer->data[i+j]);
+        }
+        UART0_puts(hex_str);
+    }
+    UART0_puts("\n");
+}
@@ -0,0 +1,56 @@
+
+/**
+ * @file    baud.h
+ * @brief   Contains the definitions and function prototypes for the console baud rate fallback policy.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef BAUD_H
+	#define BAUD_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	#define BAUD_WINDOW_TICKS       10  /// Length of an evaluation window, in systime ticks (1 second)
+
+	// Policy thresholds, defaults of the BAUD_* tunables
+	#define BAUD_ERR_LIMIT          4   /// Line errors in a window that make it a bad window
+	#define BAUD_BAD_WINDOWS        3   /// Bad windows in a row before stepping the rate down
+	#define BAUD_QUIET_WINDOWS      60  /// Error free windows in a row before stepping the rate back up
+	#define BAUD_CONFIRM_WINDOWS    5   /// Windows the host has to confirm a new rate before it's reverted
+
+	/**
+	 * @brief   Policy states.
+	 * @details While confirming, the rate has just changed and the host hasn't sent "baud ok" at it yet.
+	 */
+	enum BAUD_STATES {BAUD_STABLE, BAUD_CONFIRMING};
+
+	/**
+	 * @brief   Baud rate policy descriptor.
+	 * @details level indexes the rate table (0 is the fastest rate),
+	 *          prev_level is the rate to go back to if a change isn't confirmed.
+	 */
+	typedef struct baud_policy_ {
+	    uint8_t         level;
+	    uint8_t         prev_level;
+	    uint8_t         state;
+	    bool            auto_en;
+	    uint32_t        last_errors;
+	    uint16_t        ticks;
+	    volatile bool   window;
+	    uint16_t        bad_windows;
+	    uint16_t        quiet_windows;
+	    uint16_t        confirm_windows;
+	    uint32_t        steps_down;
+	    uint32_t        steps_up;
+	    uint32_t        reverts;
+	} baud_policy_t;
+
+	void Baud_Init(void);
+	bool Baud_Query(char* args);
+	void Baud_Update(void);
+	void Baud_Tick(void);
+
+#endif	// BAUD_H
@@ -0,0 +1,31 @@
+
+/**
+ * @file    bench.h
+ * @brief   Contains the definitions and function prototypes for the on-device microbenchmarks.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef BENCH_H
+	#define BENCH_H
+
+	#include <stdint.h>
+	#include "cpu.h"
+
+	#define BENCH_ITERATIONS    64  /// Iterations averaged per benchmark row
+	#define BENCH_TX_LENGTH     64  /// Bytes pushed through UART0_put for the TX throughput row
+
+	/**
+	 * @brief   Times a single statement with the DWT cycle counter
+	 *          and adds the elapsed cycles to an accumulator.
+	 */
+	#define BENCH_TIME(acc, stmt) do {          \
+	    uint32_t t0_ = CYCCNT();                \
+	    stmt;                                   \
+	    (acc) += CYCCNT() - t0_;                \
+	} while (0)
+
+	void Bench_Run(void);
+
+#endif	// BENCH_H
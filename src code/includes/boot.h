@@ -0,0 +1,46 @@
+
+/**
+ * @file    boot.h
+ * @brief   Contains the definitions and function prototypes for boot-time profiling.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef BOOT_H
+	#define BOOT_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	/**
+	 * @brief   Boot phases, in the order they complete.
+	 * @details BOOT_MAIN is the time origin (the cycle counter only starts counting once main runs).
+	 */
+	enum BOOT_PHASES {
+	    BOOT_MAIN,
+	    BOOT_UART_INIT,
+	    BOOT_SYSTIME_INIT,
+	    BOOT_IRQMON_INIT,
+	    BOOT_SYSTICK_START,
+	    BOOT_QUERY_INIT,
+	    BOOT_FIRST_PROMPT,
+	    BOOT_FIRST_QUERY,
+	    BOOT_PHASE_COUNT
+	};
+
+	/**
+	 * @brief   Boot profile.
+	 * @details stamps are cycle counter values, only valid for the phases with their bit set in done.
+	 */
+	typedef struct boot_profile_ {
+	    uint32_t    stamps[BOOT_PHASE_COUNT];
+	    uint32_t    done;
+	} boot_profile_t;
+
+	void Boot_Start(void);
+	void Boot_Mark(uint8_t phase);
+	void Boot_Update(void);
+	void Boot_Report(void);
+
+#endif	// BOOT_H
@@ -0,0 +1,87 @@
+
+/**
+ * @file    bridge.h
+ * @brief   Contains all the definitions and function prototypes for the UART bridge/line sniffer.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef BRIDGE_H
+	#define BRIDGE_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "cpu.h"
+	#include "uart_port.h"
+	#include "lz_stream.h"
+
+	#define BRIDGE_UART_A       2       /// UART bridged on side A (PA6 = U2RX, PA7 = U2TX)
+	#define BRIDGE_UART_B       3       /// UART bridged on side B (PA4 = U3RX, PA5 = U3TX)
+	#define INT_VEC_UART2       33      // UART2 Rx and Tx interrupt index (decimal)
+	#define INT_VEC_UART3       56      // UART3 Rx and Tx interrupt index (decimal)
+	#define BRIDGE_BAUD         115200
+
+	#define BRIDGE_PA_PINS      0xF0        // PA4-7
+	#define BRIDGE_PA_PCTL      0x11110000  // U3RX/U3TX/U2RX/U2TX on PA4-7
+
+	#define BRIDGE_DIR_A_TO_B   0x00
+	#define BRIDGE_DIR_B_TO_A   0x01
+
+	/**
+	 * @brief   Capture record header byte.
+	 * @details The upper nibble never changes, so the host can resync on it.
+	 *          The lowest bit is the direction tag.
+	 */
+	#define BRIDGE_RECORD_SYNC  0xA0
+	#define BRIDGE_RECORD_SIZE  4
+
+	#define BRIDGE_CYC_PER_US   (F_CPU_CLK/1000000)    /// Cycle counter ticks per timestamp unit
+
+	#define BRIDGE_LZ_CHUNK     64  /// Capture bytes gathered before compressing a chunk (fewer literal run headers), SNIFF_LZ_CHUNK tunable default
+
+	/**
+	 * @brief   Max size of count records once packed for compression (see Bridge_Pack()):
+	 *          count byte, direction bitmap, up to 3 bytes of delta and the data byte per record.
+	 */
+	#define BRIDGE_PACK_BOUND(count)    (1 + ((count) + 7)/8 + 4*(count))
+
+	/**
+	 * @brief   Capture record, as sent to the console.
+	 * @details [header: SYNC | dir][delta_us: 16-bit little endian][data].
+	 *          delta_us is the time since the previous record, in microseconds,
+	 *          saturated at 0xFFFF.
+	 */
+	typedef struct bridge_record_ {
+	    uint8_t header;
+	    uint8_t delta_lo;
+	    uint8_t delta_hi;
+	    uint8_t data;
+	} bridge_record_t;
+
+	/**
+	 * @brief   Bridge/sniffer descriptor.
+	 */
+	typedef struct bridge_ {
+	    uart_port_t         a;
+	    uart_port_t         b;
+	    circular_buffer_t   capture;
+	    uint32_t            last_stamp;
+	    uint32_t            records;
+	    uint32_t            dropped;
+	    uint32_t            fwd_dropped;
+	    bool                en;
+	    bool                echo_restore;
+	    bool                compress;
+	    lz_stream_t         lz;
+	} bridge_t;
+
+	void Bridge_Start(bool compress);
+	void Bridge_Stop(void);
+	bool Bridge_Sniffing(void);
+	void Bridge_Update(circular_buffer_t* rx_buf);
+
+	void UART2_IntHandler(void);
+	void UART3_IntHandler(void);
+
+#endif	// BRIDGE_H
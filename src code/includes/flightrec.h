@@ -0,0 +1,130 @@
+
+/**
+ * @file    flightrec.h
+ * @brief   Contains all the definitions, structures and function prototypes for the reset-surviving flight recorder.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef FLIGHTREC_H
+	#define FLIGHTREC_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "cpu.h"
+	#include "uart.h"
+	#include "isr_stats.h"
+
+	#define FLIGHTREC_MAGIC         0x464C5452  /// "FLTR", marks a recorder left by a previous run
+	#define FLIGHTREC_TRACE_RECORDS 64          /// Trace records kept (the oldest are overwritten)
+	/**
+	 * @brief   Seconds without a main loop pass before the watchdog seals the recorder (and as many again to the reset).
+	 * @details The main loop may block on: console output (UART0_write waits for TX buffer room,
+	 *          bytes going out feed the watchdog, so long dumps at 9600 baud are fine),
+	 *          waits for an idle console (one TX buffer, about 130 ms at 9600 baud),
+	 *          the linktest (about 2 s over all its rates) and EEPROM writes (set save).
+	 *          Nothing waits on console input, escape codes are parsed across updates.
+	 */
+	#define FLIGHTREC_WDT_TIMEOUT   4
+
+	// Watchdog Timer 0 (runs off the system clock)
+	#define WDT0_LOAD_R         (*((volatile unsigned long *)0x40000000))   /// Watchdog Load Register
+	#define WDT0_CTL_R          (*((volatile unsigned long *)0x40000008))   /// Watchdog Control Register
+	#define WDT0_ICR_R          (*((volatile unsigned long *)0x4000000C))   /// Watchdog Interrupt Clear Register (any write reloads the counter)
+	#define WDT0_TEST_R         (*((volatile unsigned long *)0x40000418))   /// Watchdog Test Register
+
+	#define WDT_CTL_INTEN       0x00000001  // Interrupt (and counter) enable, only cleared by a reset
+	#define WDT_CTL_RESEN       0x00000002  // Reset on the second time-out
+	#define WDT_CTL_INTTYPE_NMI 0x00000004  // The time-out interrupt is an NMI
+	#define WDT_TEST_STALL      0x00000100  // Stop counting while the debugger halts the CPU
+
+	#define SYSCTL_RCGCWD_R     (*((volatile unsigned long *)0x400FE600))   /// Watchdog Clock Gating Register
+	#define SYSCTL_PRWD_R       (*((volatile unsigned long *)0x400FEA00))   /// Watchdog Peripheral Ready Register
+	#define SYSCTL_RESC_R       (*((volatile unsigned long *)0x400FE05C))   /// Reset Cause Register
+
+	#define SYSCTL_RCGCWD_WDT0  0x00000001  // Watchdog 0 Clock Gating Control
+
+	#define SYSCTL_RESC_EXT     0x00000001  // External (pin) reset
+	#define SYSCTL_RESC_POR     0x00000002  // Power-on reset
+	#define SYSCTL_RESC_BOR     0x00000004  // Brown-out reset
+	#define SYSCTL_RESC_WDT0    0x00000008  // Watchdog 0 reset
+	#define SYSCTL_RESC_SW      0x00000010  // Software reset
+	#define SYSCTL_RESC_POWER   (SYSCTL_RESC_POR | SYSCTL_RESC_BOR)    // Resets that lose the RAM contents
+
+	/**
+	 * @brief   Trace events.
+	 * @details QUERY/QUERY_END and ALARM_IN/ALARM_OUT come in pairs, a run that ends on an unpaired one
+	 *          locked up inside that query or alarm callback.
+	 */
+	enum FLIGHTREC_EVENTS {
+	    FLIGHTREC_BOOT,         // arg: reset cause, data: boots survived
+	    FLIGHTREC_QUERY,        // arg: query index
+	    FLIGHTREC_QUERY_END,    // arg: query index, data: query was valid
+	    FLIGHTREC_ALARM_IN,     // data: free UART0 TX buffer space (0 means it had to wait for room)
+	    FLIGHTREC_ALARM_OUT,
+	    FLIGHTREC_BAUD,         // arg: rate level, data: new baud rate / 100
+	    FLIGHTREC_WATCHDOG,
+	    FLIGHTREC_EVENT_COUNT
+	};
+
+	/**
+	 * @brief   Why the recorder was sealed (its CRC computed).
+	 * @details A run that ended on a reset the recorder didn't see coming is left unsealed,
+	 *          only its trace is worth reading then.
+	 */
+	enum FLIGHTREC_SEALS {FLIGHTREC_UNSEALED, FLIGHTREC_SEAL_WATCHDOG, FLIGHTREC_SEAL_REBOOT};
+
+	/**
+	 * @brief   Trace record.
+	 * @details ticks is the uptime in systime ticks (tenths of a second).
+	 */
+	typedef struct flightrec_trace_ {
+	    uint32_t    ticks;
+	    uint8_t     event;
+	    uint8_t     arg;
+	    uint16_t    data;
+	} flightrec_trace_t;
+
+	/**
+	 * @brief   Counters snapshot, taken when the recorder is sealed.
+	 */
+	typedef struct flightrec_counters_ {
+	    uint32_t            isr_calls[ISR_COUNT];
+	    uint32_t            rx_dropped;
+	    uart_line_errors_t  errors;
+	    uint32_t            baud;
+	} flightrec_counters_t;
+
+	/**
+	 * @brief   Flight recorder, kept in RAM that isn't initialized on reset.
+	 * @details The trace is written live, everything from seal onwards is only filled in when sealing.
+	 *          shcsr and active are the exception state at that point (which handlers were running),
+	 *          rx and tx are copies of the UART0 buffers (data and pointers).
+	 *          crc covers everything before it.
+	 */
+	typedef struct flightrec_ {
+	    uint32_t                magic;
+	    uint32_t                boots;
+	    uint32_t                ticks;
+	    uint32_t                trace_count;
+	    flightrec_trace_t       trace[FLIGHTREC_TRACE_RECORDS];
+	    uint32_t                seal;
+	    uint32_t                shcsr;
+	    uint32_t                active[2];
+	    flightrec_counters_t    counters;
+	    circular_buffer_t       rx;
+	    circular_buffer_t       tx;
+	    uint32_t                crc;
+	} flightrec_t;
+
+	void FlightRec_Init(uart_descriptor_t* uart);
+	void FlightRec_Trace(uint8_t event, uint8_t arg, uint16_t data);
+	bool FlightRec_Query(char* args);
+	void FlightRec_Update(void);
+	void FlightRec_Tick(void);
+	void FlightRec_SetTimeout(uint32_t seconds);
+
+	void FlightRec_NmiHandler(void);
+
+#endif	// FLIGHTREC_H
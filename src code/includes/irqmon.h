@@ -0,0 +1,66 @@
+
+/**
+ * @file    irqmon.h
+ * @brief   Contains all the definitions, structures and function prototypes for the external interrupt monitor.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef IRQMON_H
+	#define IRQMON_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "circular_buffer.h"
+	#include "gpio.h"
+
+	#define IRQMON_PORT_BASE    GPIO_PORTL_BASE
+	#define IRQMON_PINS         4                       /// Monitored pins: PL0..PL3
+	#define IRQMON_PIN_MASK     ((1 << IRQMON_PINS) - 1)
+
+	#define IRQMON_WINDOW_BUCKETS   10  /// Sliding window length, in systime ticks (1 second)
+
+	#define IRQMON_LOG_SYNC         0xE0    /// Edge log record header, [SYNC | level << 4 | pin]
+	#define IRQMON_LOG_RECORD_SIZE  5       /// [header][32-bit LE cycle counter stamp]
+	#define IRQMON_LZ_RECORDS       16      /// Records compressed per chunk by "irqmon dump z"
+
+	/**
+	 * @brief   Monitored pin statistics.
+	 * @details Inter-arrival times are in cycle counter ticks.
+	 *          Both edges are monitored, so two edges in a row with the same pin level
+	 *          means at least one edge went unnoticed (counted in missed).
+	 */
+	typedef struct irqmon_pin_ {
+	    uint32_t    edges;
+	    uint32_t    missed;
+	    uint32_t    last_stamp;
+	    uint32_t    min_dt;
+	    uint32_t    max_dt;
+	    uint32_t    window_edges;
+	    uint16_t    buckets[IRQMON_WINDOW_BUCKETS];
+	    uint8_t     last_level;
+	} irqmon_pin_t;
+
+	/**
+	 * @brief   Interrupt monitor descriptor.
+	 */
+	typedef struct irqmon_ {
+	    irqmon_pin_t        pins[IRQMON_PINS];
+	    uint8_t             bucket;
+	    bool                log_en;
+	    uint32_t            log_dropped;
+	    circular_buffer_t   log;
+	} irqmon_t;
+
+	void IrqMon_Init(void);
+	void IrqMon_Reset(void);
+	void IrqMon_Edge(uint8_t pin, uint32_t stamp, uint8_t level);
+	void IrqMon_Tick(void);
+	circular_buffer_t* IrqMon_Log(void);
+
+	bool IrqMon_Query(char* args);
+
+	void GPIOL_IntHandler(void);
+
+#endif	// IRQMON_H
@@ -0,0 +1,69 @@
+
+/**
+ * @file    linktest.h
+ * @brief   Contains the definitions and function prototypes for the UART loopback self-test.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef LINKTEST_H
+	#define LINKTEST_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "cpu.h"
+	#include "uart_port.h"
+
+	#define LINKTEST_UART       4       /// Spare UART run in internal loopback (no pins needed)
+	#define INT_VEC_UART4       57      // UART4 Rx and Tx interrupt index (decimal)
+
+	#define LINKTEST_BYTES      1024    /// Bytes pushed through the loopback per baud rate
+	#define LINKTEST_CHUNK      16      /// Max bytes queued per UARTPort_put call
+	#define LINKTEST_STAMPS     256     /// TX stamps kept (must cover every byte in flight: ring + both FIFOs)
+	#define LINKTEST_STAMP_MASK (LINKTEST_STAMPS - 1)
+	#define LINKTEST_RESYNC     16      /// Max bytes looked ahead to resync the pattern after a lost byte
+	#define LINKTEST_BUCKETS    16      /// Latency histogram buckets, bucket k holds [2^k, 2^(k+1)) us
+
+	#define LINKTEST_CYC_PER_US (F_CPU_CLK/1000000)
+
+	/**
+	 * @brief   Test pattern, byte i of the stream.
+	 * @details 167 is odd, so every 256 byte block is a permutation of all the byte values,
+	 *          and the high bits of i make consecutive blocks differ.
+	 */
+	#define LINKTEST_PATTERN(i) ((uint8_t)(((i) * 167) ^ ((i) >> 8)))
+
+	/**
+	 * @brief   Results of a run at a single baud rate.
+	 * @details Latencies run from a byte being queued in the TX ring to it reaching the RX interrupt handler.
+	 * @details received and last_rx are written by the UART4 interrupt handler while the main loop waits.
+	 */
+	typedef struct linktest_result_ {
+	    uint32_t    sent;
+	    volatile uint32_t   received;
+	    uint32_t    mismatched;
+	    uint32_t    lost;
+	    uint32_t    line_errors;
+	    uint32_t    first_tx;
+	    volatile uint32_t   last_rx;
+	    uint32_t    lat_min;
+	    uint32_t    lat_max;
+	    uint32_t    hist[LINKTEST_BUCKETS];
+	} linktest_result_t;
+
+	/**
+	 * @brief   Link test descriptor.
+	 */
+	typedef struct linktest_ {
+	    uart_port_t         port;
+	    uint32_t            stamps[LINKTEST_STAMPS];
+	    volatile uint32_t   expected;   /// Index of the next byte expected on RX (the RX handler advances it)
+	    linktest_result_t   result;
+	} linktest_t;
+
+	bool LinkTest_Query(char* args);
+
+	void UART4_IntHandler(void);
+
+#endif	// LINKTEST_H
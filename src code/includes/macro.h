@@ -0,0 +1,114 @@
+
+/**
+ * @file    macro.h
+ * @brief   Contains the definitions and function prototypes for stored query macros.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef MACRO_H
+	#define MACRO_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "circular_buffer.h"
+
+	#define MACRO_MAX           8       /// Amount of macros that can be stored
+	#define MACRO_NAME_LEN      8       /// Max macro name length
+	#define MACRO_NAME_SCAN     "%8s"   /// Macro name scan format (MACRO_NAME_LEN characters)
+	#define MACRO_POOL_SIZE     512     /// Bytecode storage shared by all the macros
+	#define MACRO_CODE_MAX      256     /// Max bytecode length of a single macro
+	#define MACRO_DEPTH         4       /// Max nesting of REPEAT/IF blocks
+	#define MACRO_STEPS         16      /// Max instructions run per main loop update
+	#define MACRO_DUMP_BYTES    16      /// Bytes per line of a macro dump
+
+	/**
+	 * @brief   Macro bytecode instructions.
+	 * @details Operands follow the opcode, 16-bit operands are little endian.
+	 *          Jump targets are offsets from the start of the macro.
+	 */
+	enum MACRO_OPS {
+	    MACRO_OP_END,       /// []                              stop
+	    MACRO_OP_QUERY,     /// [query index]                   run a query without set data
+	    MACRO_OP_QUERY_SET, /// [query index][set data...][\0]  run a query with set data
+	    MACRO_OP_REPEAT,    /// [count]                         open a loop (count 0 loops forever)
+	    MACRO_OP_LOOP,      /// [body]                          close a loop, jumps back to body while it has iterations left
+	    MACRO_OP_IF_OK,     /// [target]                        jump to target if the last query failed
+	    MACRO_OP_IF_ERR,    /// [target]                        jump to target if the last query succeeded
+	    MACRO_OP_JUMP,      /// [target]                        jump to target
+	    MACRO_OP_WAIT       /// [ticks]                         pause for a number of systime ticks
+	};
+
+	/**
+	 * @brief   Stored macro.
+	 * @details The bytecode lives in the shared pool, macros are kept packed in definition order.
+	 */
+	typedef struct macro_ {
+	    char        name[MACRO_NAME_LEN + 1];
+	    uint16_t    offset;
+	    uint16_t    length;
+	} macro_t;
+
+	/**
+	 * @brief   Macro storage.
+	 */
+	typedef struct macro_store_ {
+	    macro_t     macros[MACRO_MAX];
+	    uint8_t     count;
+	    uint8_t     pool[MACRO_POOL_SIZE];
+	    uint16_t    used;
+	} macro_store_t;
+
+	/**
+	 * @brief   Block left open while compiling (REPEAT, IF or ELSE).
+	 * @details op is MACRO_OP_REPEAT, MACRO_OP_IF_OK (for either IF) or MACRO_OP_JUMP (ELSE).
+	 *          at is the loop body start for REPEAT, and the jump operand still to be patched for IF/ELSE.
+	 */
+	typedef struct macro_block_ {
+	    uint8_t     op;
+	    uint16_t    at;
+	} macro_block_t;
+
+	/**
+	 * @brief   Macro compiler, active between "macro def" and "end".
+	 */
+	typedef struct macro_compiler_ {
+	    bool            en;
+	    char            name[MACRO_NAME_LEN + 1];
+	    uint8_t         code[MACRO_CODE_MAX];
+	    uint16_t        length;
+	    macro_block_t   blocks[MACRO_DEPTH];
+	    uint8_t         depth;
+	    uint16_t        lines;
+	    uint16_t        errors;
+	} macro_compiler_t;
+
+	/**
+	 * @brief   Macro interpreter state.
+	 * @details ok is the result of the last query, tested by the IF instructions.
+	 *          counters holds the iterations left of every open loop.
+	 */
+	typedef struct macro_vm_ {
+	    bool                en;
+	    uint8_t*            code;
+	    uint16_t            pc;
+	    uint16_t            counters[MACRO_DEPTH];
+	    uint8_t             sp;
+	    bool                ok;
+	    volatile uint16_t   wait;
+	    uint32_t            queries;
+	    uint32_t            errors;
+	} macro_vm_t;
+
+	void Macro_Init(void);
+	bool Macro_Query(char* args);
+
+	bool Macro_Defining(void);
+	bool Macro_Line(char* line, uint32_t length);
+
+	bool Macro_Running(void);
+	void Macro_Update(circular_buffer_t* rx_buf);
+	void Macro_Tick(void);
+
+#endif	// MACRO_H
@@ -4,7 +4,7 @@
  * @brief   Contains all the definitions and function prototypes for the query handler.
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.10 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 
@@ -13,6 +13,7 @@
 
 	#include "uart.h"
 	#include "systime.h"
+	#include "token_bucket.h"
 
     /**
      * @brief   all query types supported by the handler.
@@ -25,6 +26,47 @@
     #define VALID_TIME_SCAN 4
     #define VALID_ALARM_SCAN VALID_TIME_SCAN
 
+    #define TIME_SCAN_FORMAT    "%2hhu:%2hhu:%2hhu.%1hhu"   /// Time/Alarm set data format
+    #define TIME_PRINT_FORMAT   "%02u:%02u:%02u.%u"         /// Time/Alarm display format
+    #define DATE_SCAN_FORMAT    "%hhu-%3s-%hu"              /// Date set data format
+    #define DATE_PRINT_FORMAT   "%02u-%3s-%04u"             /// Date display format
+    #define CURSOR_POSITION_FORMAT  "\x1b[%u;%uH"          /// Cursor move escape code (row;column, 1-based)
+
+    #define BULK_ACK_LINES      16  /// Lines processed between bulk mode acknowledgements
+    #define BULK_ERR_LOG_SIZE   8   /// Failed line numbers reported per bulk acknowledgement
+
+    /**
+     * @brief   Query classes, each with its own rate limit.
+     * @details DIAG queries are the expensive diagnostics (bench, sniff, irqmon, boot, top, linktest),
+     *          SET queries are any other query with set data.
+     */
+    enum QUERY_CLASSES{QUERY_CLASS_DISPLAY, QUERY_CLASS_SET, QUERY_CLASS_DIAG, QUERY_CLASS_COUNT};
+
+    #define QUERY_BUDGET_CHARS  32  /// Max characters taken from the RX buffer per update (and at most one query), QUERY_BUDGET tunable default
+
+    #define QUERY_HISTORY       4   /// Amount of past queries kept for the top view
+    #define QUERY_HISTORY_LEN   32  /// Max length of a kept query, including the status prefix
+
+    // Rate limits, as {burst size, ticks per token}. Ticks are tenths of a second.
+    #define SESSION_RATE_BURST  20  // QUERY_BURST tunable default
+    #define SESSION_RATE_PERIOD 1   // 10 queries/s, QUERY_PERIOD tunable default
+    #define DISPLAY_RATE_BURST  20
+    #define DISPLAY_RATE_PERIOD 1   // 10 queries/s
+    #define SET_RATE_BURST      10
+    #define SET_RATE_PERIOD     2   // 5 queries/s
+    #define DIAG_RATE_BURST     2
+    #define DIAG_RATE_PERIOD    10  // 1 query/s
+
+	/**
+	 * @brief   Query table entry.
+	 * @details handler gets the set data (NULL if there's none) and returns whether the query was valid.
+	 */
+	typedef struct query_entry_ {
+	    const char* keyword;
+	    bool        (*handler)(char* set_data);
+	    bool        macro_ok;
+	} query_entry_t;
+
 	/**
 	 * @brief   escape code buffer.
 	 *          Used to map an escape cursor code to it's individual parameters.
@@ -40,17 +82,67 @@
 	 			to keep track of the length of the entry as characters are inputted to the monitor.
 	 			(the write pointer of the circular buffer is the "cursor", 
 	 			so it can be moved while there's vald ata in front of it)
+	 * @details esc_len counts the bytes of an escape code received so far (0 if there's none in progress),
+	 			the code may arrive over several updates.
 	 */
 	typedef struct query_buffer_ {
 	    circular_buffer_t buffer;
 	    uint32_t entry_ptr;
+	    escape_code_t esc_seq;
+	    uint8_t esc_len;
 	} query_buffer_t;
 
+	/**
+	 * @brief   Bulk (paste/upload) mode session.
+	 * @details While enabled, echo and prompts are off and query replies are suppressed.
+	 *          Lines are instead acknowledged in batches of BULK_ACK_LINES,
+	 *          with the line numbers of any entries that failed.
+	 */
+	typedef struct bulk_session_ {
+	    bool        en;
+	    bool        echo_restore;
+	    uint32_t    lines;
+	    uint32_t    errors;
+	    uint32_t    batch_lines;
+	    uint32_t    batch_errors;
+	    uint32_t    batch_err_lines[BULK_ERR_LOG_SIZE];
+	} bulk_session_t;
+
+	/**
+	 * @brief   Query session.
+	 * @details Rate limits (overall and per query class) and statistics of the terminal session.
+	 *          A line that's over its rate limit is dropped and counted in throttled.
+	 * @details history keeps the last QUERY_HISTORY queries, prefixed with "? " if they failed.
+	 */
+	typedef struct query_session_ {
+	    token_bucket_t  limit;
+	    token_bucket_t  class_limit[QUERY_CLASS_COUNT];
+	    uint32_t        queries;
+	    uint32_t        errors;
+	    uint32_t        throttled;
+	    uint32_t        yields;
+	    char            history[QUERY_HISTORY][QUERY_HISTORY_LEN];
+	    uint8_t         history_head;
+	} query_session_t;
+
+	extern char CLEAR_SCREEN[];
+	extern char CURSOR_HOME[];
+	extern char CURSOR_HIDE[];
+	extern char CURSOR_SHOW[];
+
 	void QueryHandler_Init();
+	void QueryHandler_Tick(void);
+	void QueryHandler_SetRateLimit(uint16_t burst, uint16_t period);
 
 	void QueryHandler_Update(circular_buffer_t* rx_buf);
 	bool QueryCheck();
 
+	void QuerySplit(char* query_str, uint32_t length, char** keyword, char** set_data);
+	int8_t QueryFind(char* keyword);
+	bool QueryMacroAllowed(uint8_t index);
+	bool QueryRun(uint8_t index, char* set_data);
+	const char* QueryKeyword(uint8_t index);
+
 	bool SetTime(char* clock_str);
 	void DisplayTime(void);
 
@@ -61,6 +153,12 @@
 
 	void Alarm_callback(void);
 
-	void CursorCodeCheck(circular_buffer_t* rx_buf);
+	void DisplayStats(void);
+	const char* QueryHistory(uint8_t age);
+
+	void BulkStart(void);
+	void BulkEnd(void);
+
+	void CursorCodeCheck(char data);
 
 #endif	// COMMAND_HANDLER_H
@@ -5,7 +5,7 @@
  *          Contains all the definitions and prototypes for the systime module.
  * @author  Manuel Burnay
  * @date    2019.09.24 (Created)
- * @date    2019.10.03 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 #ifndef SYSTIME_H
@@ -50,6 +50,22 @@
 	    void (*alarm_cb)(void);
 	} alarm_t;
 
+	/**
+	 * @brief   Enables the ASCII clock representation.
+	 * @details When enabled, systime keeps a "hh:mm:ss.t" string up to date on every tick
+	 *          (digit increments with carry propagation, no divisions)
+	 *          and re-renders a "dd-MMM-yyyy" string only when the date changes,
+	 *          so displaying the time or date is a fixed-size copy.
+	 */
+	#ifndef SYSTIME_ASCII_CLOCK
+		#define SYSTIME_ASCII_CLOCK 1
+	#endif
+
+	#define SYSTIME_TICK_HOOKS		8	/// Max amount of functions called on every tick (see systime_AddTickHook)
+
+	#define SYSTIME_CLOCK_STR_LEN	10	/// Length of "hh:mm:ss.t"
+	#define SYSTIME_DATE_STR_LEN	11	/// Length of "dd-MMM-yyyy"
+
 	/**
 	 * @brief   System time strucure.
 	 * @details Contains all the elements the system time middleware controls and maintains/handles.
@@ -57,6 +73,12 @@
 	typedef struct systime_ {
 		date_t date;
 		systick_descriptor_t systick;
+		void (*tick_hooks[SYSTIME_TICK_HOOKS])(void);
+		uint8_t tick_hook_count;
+	#if SYSTIME_ASCII_CLOCK
+		char clock_str[SYSTIME_CLOCK_STR_LEN];
+		char date_str[SYSTIME_DATE_STR_LEN];
+	#endif
 	} systime_t;
 
 	#define MSEC_IN_TSEC 100
@@ -85,6 +107,8 @@
 	 */
     #define IS_LEAP_YR(yr) ((yr % 4 == 0) && ((yr % 400 == 0) || (yr % 100 != 0)))
 
+	extern const char* const MONTHS[MONTH_IN_YEAR];
+
 	void systime_init();
 
 	bool systime_SetTime(clock_t* new_clock);
@@ -94,5 +118,16 @@
 
 	bool systime_SetAlarm(clock_t* alarm_clock, void (*alarm_cb)(void));
 	void systime_ClearAlarm();
+	bool systime_GetAlarm(clock_t* remaining);
+
+	void systime_IncDate_callback(void);
+
+	bool systime_AddTickHook(void (*hook)(void));
+	void systime_SetTrim(int32_t ppm);
+
+	#if SYSTIME_ASCII_CLOCK
+	void systime_GetTimeStr(char* ret_str);
+	void systime_GetDateStr(char* ret_str);
+	#endif
 
 #endif		// SYSTIME_H
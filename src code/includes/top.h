@@ -0,0 +1,55 @@
+
+/**
+ * @file    top.h
+ * @brief   Contains the definitions and function prototypes for the live top view.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef TOP_H
+	#define TOP_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include "uart.h"
+	#include "isr_stats.h"
+
+	#define TOP_ROWS            22  /// Rows of the top view
+	#define TOP_COLS            48  /// Columns of the top view
+
+	#define TOP_PERIOD_DEFAULT  10  /// Refresh period, in systime ticks (1 second)
+	#define TOP_PERIOD_MAX      100 /// Slowest refresh period allowed (10 seconds)
+
+	/**
+	 * @brief   Unchanged cells re-sent rather than moving the cursor past them.
+	 * @details A cursor move costs 6 to 8 bytes, so short runs of unchanged cells are cheaper to resend.
+	 */
+	#define TOP_MERGE_GAP       6
+
+	/**
+	 * @brief   Top view descriptor.
+	 * @details screen mirrors what the terminal is showing,
+	 *          so a refresh only sends the cells that changed since the previous one.
+	 *          Rates are computed from the statistics sampled at the previous refresh.
+	 */
+	typedef struct top_ {
+	    char            screen[TOP_ROWS][TOP_COLS];
+	    isr_stat_t      last_isr[ISR_COUNT];
+	    uint32_t        last_stamp;
+	    uint32_t        loops;
+	    uint16_t        period;
+	    uint16_t        ticks;
+	    volatile bool   refresh;
+	    bool            en;
+	    bool            echo_restore;
+	} top_t;
+
+	void Top_Init(void);
+	bool Top_Query(char* args);
+	void Top_Stop(void);
+	bool Top_Running(void);
+	void Top_Update(uart_descriptor_t* uart);
+	void Top_Tick(void);
+
+#endif	// TOP_H
@@ -0,0 +1,71 @@
+
+/**
+ * @file    tunables.h
+ * @brief   Contains all the definitions, structures and function prototypes for the runtime tunables registry.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ */
+
+#ifndef TUNABLES_H
+	#define TUNABLES_H
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	#define TUNABLES_MAGIC          0x54554E00  /// "TUN" + tunable count, marks saved tunables (a new layout invalidates them)
+	#define TUNABLES_EEPROM_ADDR    0           /// EEPROM word address of the saved tunables
+
+	/**
+	 * @brief   Tunables, in registry order.
+	 */
+	enum TUNABLE_IDS {
+	    TUNE_TICK_TRIM,
+	    TUNE_UART0_RX_LEVEL,
+	    TUNE_UART0_TX_LEVEL,
+	    TUNE_ECHO,
+	    TUNE_QUERY_BUDGET,
+	    TUNE_QUERY_BURST,
+	    TUNE_QUERY_PERIOD,
+	    TUNE_SNIFF_LZ_CHUNK,
+	    TUNE_BAUD_ERR_LIMIT,
+	    TUNE_BAUD_BAD_WINDOWS,
+	    TUNE_BAUD_QUIET_WINDOWS,
+	    TUNE_BAUD_CONFIRM_WINDOWS,
+	    TUNE_WDT_TIMEOUT,
+	    TUNE_COUNT
+	};
+
+	/**
+	 * @brief   Tunables registry entry.
+	 * @details apply pushes a new value to its owner, it can be called from the main loop at any time,
+	 *          so it has to be safe against the interrupt handlers using the same settings.
+	 *          Tunables without one are read by their owner (Tunables_Get) each time they're used.
+	 */
+	typedef struct tunable_ {
+	    const char* name;
+	    int32_t     min;
+	    int32_t     max;
+	    int32_t     def;
+	    void        (*apply)(int32_t value);
+	} tunable_t;
+
+	/**
+	 * @brief   Saved tunables, as laid out in the EEPROM.
+	 * @details crc covers everything before it.
+	 */
+	typedef struct tunables_record_ {
+	    uint32_t    magic;
+	    int32_t     values[TUNE_COUNT];
+	    uint32_t    crc;
+	} tunables_record_t;
+
+	void Tunables_Init(void);
+	int32_t Tunables_Get(uint8_t id);
+	bool Tunables_Set(uint8_t id, int32_t value);
+
+	bool Tunables_GetQuery(char* args);
+	bool Tunables_SetQuery(char* args);
+	bool Tunables_ListQuery(char* args);
+
+#endif	// TUNABLES_H
@@ -0,0 +1,333 @@
+
+/**
+ * @file    irqmon.c
+ * @brief   External interrupt-rate monitor.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Monitors PL0..PL3 as both-edge GPIO interrupts.
+ *          Each edge is stamped with the DWT cycle counter and counted per pin,
+ *          rates come from a sliding window of per-tick edge counts that the systime tick rolls over.
+ *          Edges can optionally be logged into a buffer to be dumped/streamed.
+ * @details All edges go through IrqMon_Edge(), so the statistics can be driven by simulated stimulus
+ *          (see the "irqmon sim" query) without anything wired to the pins.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include "cpu.h"
+#include "irqmon.h"
+#include "systime.h"
+#include "uart.h"
+#include "lz_stream.h"
+#include "isr_stats.h"
+
+#define IRQMON_CYC_PER_US   (F_CPU_CLK/1000000)
+
+#define IRQMON_SIM_MAX_EDGES    10000   // Max edges per "irqmon sim", they're injected from the main loop (tens of ms)
+#define IRQMON_SIM_MAX_PERIOD   (0xFFFFFFFFu / IRQMON_CYC_PER_US)   // Max "irqmon sim" period (us) that fits in cycles
+
+static irqmon_t irqmon;
+
+static void IrqMon_Report(void);
+static void IrqMon_Dump(void);
+static void IrqMon_DumpCompressed(void);
+static bool IrqMon_Simulate(char* args);
+
+/**
+ * @brief   Initializes the interrupt monitor and the monitored GPIO pins.
+ * @details Make sure systime has been initialized prior to calling this function,
+ *          the sliding window is rolled over by a systime tick hook.
+ */
+void IrqMon_Init(void)
+{
+    IrqMon_Reset();
+    irqmon.log_en = false;
+    circular_buffer_init(&irqmon.log);
+
+    CYCCNT_ENABLE();
+    systime_AddTickHook(IrqMon_Tick);
+
+    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_PORTL;                 // Enable Clock Gating for Port L
+    while (!(SYSCTL_PRGPIO_R & SYSCTL_RCGCGPIO_PORTL)) ;        // Wait until it's ready to be accessed
+
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_DIR_OFFSET) &= ~IRQMON_PIN_MASK;    // Inputs
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_AFSEL_OFFSET) &= ~IRQMON_PIN_MASK;
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_DEN_OFFSET) |= IRQMON_PIN_MASK;
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_IS_OFFSET) &= ~IRQMON_PIN_MASK;     // Edge sensitive
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_IBE_OFFSET) |= IRQMON_PIN_MASK;     // on both edges
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_ICR_OFFSET) = IRQMON_PIN_MASK;
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_IM_OFFSET) |= IRQMON_PIN_MASK;
+
+    UART0_InterruptEnable(INT_VEC_GPIOL);
+}
+
+/**
+ * @brief   Clears all the pin statistics.
+ */
+void IrqMon_Reset(void)
+{
+    uint8_t pin;
+
+    DISABLE_IRQ();
+    memset(irqmon.pins, 0, sizeof(irqmon.pins));
+    for (pin = 0; pin < IRQMON_PINS; pin++) {
+        irqmon.pins[pin].min_dt = UINT32_MAX;
+    }
+    irqmon.bucket = 0;
+    irqmon.log_dropped = 0;
+    ENABLE_IRQ();
+}
+
+/**
+ * @brief   Records an edge on a monitored pin.
+ * @param   [in] pin: pin number (0..IRQMON_PINS-1).
+ * @param   [in] stamp: cycle counter value at the edge.
+ * @param   [in] level: pin level right after the edge.
+ * @details Called from the GPIO interrupt handler, so it is kept to a handful of adds/compares.
+ */
+void IrqMon_Edge(uint8_t pin, uint32_t stamp, uint8_t level)
+{
+    irqmon_pin_t* ch = &irqmon.pins[pin];
+    uint32_t dt;
+    uint8_t record[IRQMON_LOG_RECORD_SIZE];
+
+    if (ch->edges) {
+        dt = stamp - ch->last_stamp;
+        if (dt < ch->min_dt) ch->min_dt = dt;
+        if (dt > ch->max_dt) ch->max_dt = dt;
+        if (level == ch->last_level) ch->missed++;
+    }
+
+    ch->last_stamp = stamp;
+    ch->last_level = level;
+    ch->edges++;
+    ch->window_edges++;
+    ch->buckets[irqmon.bucket]++;
+
+    if (irqmon.log_en) {
+        if ((CIRCULAR_BUFFER_MASK - buffer_size(&irqmon.log)) >= IRQMON_LOG_RECORD_SIZE) {
+            record[0] = IRQMON_LOG_SYNC | (level << 4) | pin;
+            memcpy(record+1, &stamp, sizeof(stamp));    // little endian, same as the host
+            enqueue(&irqmon.log, (char*)record, IRQMON_LOG_RECORD_SIZE);
+        }
+        else {
+            irqmon.log_dropped++;
+        }
+    }
+}
+
+/**
+ * @brief   Gets the edge log buffer (for occupancy reporting).
+ */
+circular_buffer_t* IrqMon_Log(void)
+{
+    return &irqmon.log;
+}
+
+/**
+ * @brief   Rolls the sliding window over by one tick.
+ * @details Registered as a systime tick hook.
+ *          The oldest bucket is taken out of every pin's window count and reused for the new tick.
+ */
+void IrqMon_Tick(void)
+{
+    uint8_t pin;
+
+    irqmon.bucket = (irqmon.bucket + 1) % IRQMON_WINDOW_BUCKETS;
+
+    for (pin = 0; pin < IRQMON_PINS; pin++) {
+        irqmon.pins[pin].window_edges -= irqmon.pins[pin].buckets[irqmon.bucket];
+        irqmon.pins[pin].buckets[irqmon.bucket] = 0;
+    }
+}
+
+/**
+ * @brief   Interrupt Handler for GPIO Port L.
+ * @details Needs to be registered in the interrupt vector table, like UART0_IntHandler.
+ *          The cycle counter and pin levels are sampled once for all the pins that interrupted.
+ */
+void GPIOL_IntHandler(void)
+{
+    uint32_t stamp = CYCCNT();
+    unsigned long status = GPIO_REG(IRQMON_PORT_BASE, GPIO_MIS_OFFSET);
+    unsigned long levels = GPIO_REG(IRQMON_PORT_BASE, GPIO_DATA_OFFSET(IRQMON_PIN_MASK));
+    uint8_t pin;
+    ISR_STATS_ENTER();
+
+    GPIO_REG(IRQMON_PORT_BASE, GPIO_ICR_OFFSET) = status;
+
+    for (pin = 0; status; pin++, status >>= 1, levels >>= 1) {
+        if (status & 1) {
+            IrqMon_Edge(pin, stamp, levels & 1);
+        }
+    }
+
+    ISR_STATS_EXIT(ISR_GPIOL);
+}
+
+/**
+ * @brief   Services the irqmon query.
+ * @param   [in] args: query set data (NULL if there is none). Supported forms:
+ *          - (none):   per-pin report,
+ *          - RESET:    clear the statistics,
+ *          - LOG ON/OFF: enable/disable edge logging,
+ *          - DUMP:     print (and consume) the logged edges,
+ *          - DUMP Z:   same, as an LZ compressed binary stream,
+ *          - SIM <pin> <edges> <period us>: inject simulated edges.
+ * @return  [bool] True if the arguments were valid.
+ */
+bool IrqMon_Query(char* args)
+{
+    bool retval = true;
+
+    if (args == NULL) {
+        IrqMon_Report();
+    }
+    else if (strcmp(args, "RESET") == 0) {
+        IrqMon_Reset();
+    }
+    else if (strcmp(args, "LOG ON") == 0) {
+        irqmon.log_en = true;
+    }
+    else if (strcmp(args, "LOG OFF") == 0) {
+        irqmon.log_en = false;
+    }
+    else if (strcmp(args, "DUMP") == 0) {
+        IrqMon_Dump();
+    }
+    else if (strcmp(args, "DUMP Z") == 0) {
+        IrqMon_DumpCompressed();
+    }
+    else if (strncmp(args, "SIM", 3) == 0) {
+        retval = IrqMon_Simulate(args+3);
+    }
+    else {
+        retval = false;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Prints the per-pin report.
+ * @details "pin,edges,rate_hz,min_us,max_us,missed", rate over the last second.
+ */
+static void IrqMon_Report(void)
+{
+    irqmon_pin_t ch;
+    char row_str[80];
+    uint8_t pin;
+
+    UART0_puts("pin,edges,rate_hz,min_us,max_us,missed\n");
+
+    for (pin = 0; pin < IRQMON_PINS; pin++) {
+        DISABLE_IRQ();
+        ch = irqmon.pins[pin];
+        ENABLE_IRQ();
+
+        if (ch.edges < 2) ch.min_dt = 0;
+
+        sprintf(row_str, "%u,%u,%u,%u,%u,%u\n", pin, ch.edges,
+                (ch.window_edges * TSEC_IN_SEC) / IRQMON_WINDOW_BUCKETS,
+                ch.min_dt / IRQMON_CYC_PER_US, ch.max_dt / IRQMON_CYC_PER_US, ch.missed);
+        UART0_puts(row_str);
+    }
+}
+
+/**
+ * @brief   Prints the logged edges as "pin,level,stamp" text, oldest first.
+ */
+static void IrqMon_Dump(void)
+{
+    uint8_t record[IRQMON_LOG_RECORD_SIZE];
+    uint32_t stamp;
+    char row_str[32];
+
+    while (buffer_size(&irqmon.log) >= IRQMON_LOG_RECORD_SIZE) {
+        DISABLE_IRQ();
+        dequeue(&irqmon.log, record, IRQMON_LOG_RECORD_SIZE);
+        ENABLE_IRQ();
+
+        memcpy(&stamp, record+1, sizeof(stamp));
+        sprintf(row_str, "%u,%u,%u\n", record[0] & 0x0F, (record[0] >> 4) & 1, stamp);
+        UART0_puts(row_str);
+    }
+
+    sprintf(row_str, "#END DROP %u\n", irqmon.log_dropped);
+    UART0_puts(row_str);
+}
+
+/**
+ * @brief   Sends the logged edges as an LZ compressed stream, oldest first.
+ * @details "#LZ", the compressed records, then "#END DROP <dropped>" after the end of stream byte.
+ *          Records keep their binary layout, but the stamp is replaced by the cycles since the previous record
+ *          (the first one is relative to 0), which turns the stamps into short, repetitive byte patterns.
+ */
+static void IrqMon_DumpCompressed(void)
+{
+    static lz_stream_t lz;
+    uint8_t records[IRQMON_LZ_RECORDS * IRQMON_LOG_RECORD_SIZE];
+    uint8_t packed[LZ_BOUND(sizeof(records))];
+    uint32_t stamp, prev_stamp = 0, delta, length, i;
+    char row_str[32];
+
+    lz_init(&lz);
+    UART0_puts("#LZ\n");
+
+    while (buffer_size(&irqmon.log) >= IRQMON_LOG_RECORD_SIZE) {
+        length = buffer_size(&irqmon.log);
+        if (length > sizeof(records)) length = sizeof(records);
+        length -= length % IRQMON_LOG_RECORD_SIZE;
+
+        DISABLE_IRQ();
+        dequeue(&irqmon.log, records, length);
+        ENABLE_IRQ();
+
+        for (i = 0; i < length; i += IRQMON_LOG_RECORD_SIZE) {
+            memcpy(&stamp, records+i+1, sizeof(stamp));
+            delta = stamp - prev_stamp;
+            prev_stamp = stamp;
+            memcpy(records+i+1, &delta, sizeof(delta));
+        }
+
+        length = lz_compress(&lz, records, length, packed);
+        UART0_write((char*)packed, length);
+    }
+
+    UART0_write((char[]){LZ_CTRL_END}, 1);
+
+    sprintf(row_str, "\n#END DROP %u\n", irqmon.log_dropped);
+    UART0_puts(row_str);
+}
+
+/**
+ * @brief   Injects simulated edges into the monitor.
+ * @param   [in] args: "<pin> <edges> <period us>".
+ * @return  [bool] True if the arguments were valid.
+ * @details Edges alternate the pin level and are stamped period apart,
+ *          starting from the pin's last edge.
+ * @details At most IRQMON_SIM_MAX_EDGES edges and IRQMON_SIM_MAX_PERIOD us,
+ *          so the main loop isn't held up and the period doesn't wrap once in cycles.
+ */
+static bool IrqMon_Simulate(char* args)
+{
+    unsigned int pin, edges, period_us, i;
+    irqmon_pin_t* ch;
+    bool retval = false;
+
+    if (sscanf(args, "%u %u %u", &pin, &edges, &period_us) == 3 && pin < IRQMON_PINS &&
+        edges <= IRQMON_SIM_MAX_EDGES && period_us <= IRQMON_SIM_MAX_PERIOD) {
+        ch = &irqmon.pins[pin];
+
+        for (i = 0; i < edges; i++) {
+            DISABLE_IRQ();
+            IrqMon_Edge(pin, ch->last_stamp + period_us * IRQMON_CYC_PER_US, !ch->last_level);
+            ENABLE_IRQ();
+        }
+        retval = true;
+    }
+
+    return retval;
+}
@@ -0,0 +1,233 @@
+
+/**
+ * @file    linktest.c
+ * @brief   UART internal loopback throughput and latency self-test.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details A spare UART is put in internal loopback (LBE) and a known pattern is pushed through
+ *          the whole driver stack: TX ring, interrupt handler, TX FIFO, the UART itself, RX FIFO,
+ *          and back into the interrupt handler, at every baud rate in LINKTEST_BAUDS.
+ *          Nothing leaves the board, so the numbers are the driver's own ceiling on this board,
+ *          which can be held against what the real link achieves.
+ * @details The test is blocking (about 2 seconds for all the rates), like the benchmarks.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include "linktest.h"
+#include "uart.h"
+
+/** Baud rates tested. 921600 is the fastest the 16 MHz clock gets close to with 16x oversampling. */
+static const uint32_t LINKTEST_BAUDS[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+
+#define LINKTEST_BAUD_COUNT (sizeof(LINKTEST_BAUDS)/sizeof(LINKTEST_BAUDS[0]))
+
+static linktest_t linktest;
+
+static void LinkTest_Run(uint32_t baud, linktest_result_t* result);
+static void LinkTest_Receive(uart_port_t* port, char c);
+static void LinkTest_Report(uint32_t baud, linktest_result_t* result);
+static uint32_t LinkTest_Percentile(linktest_result_t* result, uint32_t percent);
+
+/**
+ * @brief   Services the linktest query.
+ * @param   [in] args: query set data, NULL to test every rate, or a single baud rate.
+ * @return  [bool] True if the arguments were valid.
+ * @details Prints "#LINKTEST", the results table, the latency histograms, then "#END".
+ *          The results table is "baud,bytes_per_s,eff_pct,lat_min_us,lat_p50_us,lat_p99_us,lat_max_us,mismatched,lost,line_errors",
+ *          eff_pct is the throughput against the 10 bit per byte line rate.
+ *          Percentiles are the upper bound of their histogram bucket.
+ *          The histogram table is "baud,h0..h15", hk counting the bytes with a latency in [2^k, 2^(k+1)) us.
+ */
+bool LinkTest_Query(char* args)
+{
+    static linktest_result_t results[LINKTEST_BAUD_COUNT];
+    unsigned int baud;
+    char trailing, row_str[24];
+    uint8_t i, first = 0, last = LINKTEST_BAUD_COUNT - 1, k;
+
+    if (args != NULL) {
+        if (sscanf(args, "%u%c", &baud, &trailing) != 1) return false;
+
+        for (i = 0; i < LINKTEST_BAUD_COUNT && LINKTEST_BAUDS[i] != baud; i++) ;
+        if (i == LINKTEST_BAUD_COUNT) return false;
+
+        first = i;
+        last = i;
+    }
+
+    UART0_puts("#LINKTEST\n");
+    while (!UART0_TxIdle()) ;   // keep the console's interrupts out of the measurements
+
+    CYCCNT_ENABLE();
+    linktest.port.rx_cb = LinkTest_Receive;
+    UARTPort_Init(&linktest.port, LINKTEST_UART, LINKTEST_BAUDS[first]);
+    UARTPort_SetLoopback(&linktest.port, true);
+    UART0_InterruptEnable(INT_VEC_UART4);
+
+    for (i = first; i <= last; i++) {
+        LinkTest_Run(LINKTEST_BAUDS[i], &results[i]);
+    }
+
+    UARTPort_SetLoopback(&linktest.port, false);
+    UARTPort_Disable(&linktest.port);
+
+    UART0_puts("baud,bytes_per_s,eff_pct,lat_min_us,lat_p50_us,lat_p99_us,lat_max_us,mismatched,lost,line_errors\n");
+    for (i = first; i <= last; i++) {
+        LinkTest_Report(LINKTEST_BAUDS[i], &results[i]);
+    }
+
+    UART0_puts("baud,h0,h1,h2,h3,h4,h5,h6,h7,h8,h9,h10,h11,h12,h13,h14,h15\n");
+    for (i = first; i <= last; i++) {
+        sprintf(row_str, "%u", LINKTEST_BAUDS[i]);
+        UART0_puts(row_str);
+        for (k = 0; k < LINKTEST_BUCKETS; k++) {
+            sprintf(row_str, ",%u", results[i].hist[k]);
+            UART0_puts(row_str);
+        }
+        UART0_puts("\n");
+    }
+
+    UART0_puts("#END\n");
+
+    return true;
+}
+
+/**
+ * @brief   Pushes LINKTEST_BYTES through the loopback at one baud rate.
+ * @param   [in] baud: baud rate.
+ * @param   [out] result: where the results are copied to.
+ * @details Bytes are queued as soon as the TX ring has room, every byte's queuing time is stamped.
+ *          Gives up on the bytes still missing after twice the expected transfer time (plus 10 ms),
+ *          but lets whatever is still queued drain before the next rate.
+ */
+static void LinkTest_Run(uint32_t baud, linktest_result_t* result)
+{
+    char chunk[LINKTEST_CHUNK];
+    uint32_t length, i, now, start;
+    uint32_t timeout = ((LINKTEST_BYTES * 10 * 2) / (baud / 1000) + 10) * (F_CPU_CLK / 1000);   // in cycles
+
+    DISABLE_IRQ();
+    UART_REG(linktest.port.base, UART_CTL_OFFSET) &= ~UART_CTL_UARTEN;   // the divisors only change while disabled
+    UARTPort_SetBaud(&linktest.port, baud);
+    UART_REG(linktest.port.base, UART_CTL_OFFSET) |= UART_CTL_UARTEN;    // keeps the loopback bit
+    circular_buffer_init(&linktest.port.tx);
+    linktest.port.rx_errors = 0;
+    memset(&linktest.result, 0, sizeof(linktest.result));
+    linktest.result.lat_min = UINT32_MAX;
+    linktest.expected = 0;
+    ENABLE_IRQ();
+
+    start = CYCCNT();
+    linktest.result.first_tx = start;
+
+    while (linktest.expected < LINKTEST_BYTES && (CYCCNT() - start) < timeout) {
+        length = CIRCULAR_BUFFER_MASK - buffer_size(&linktest.port.tx);     // the ISR only ever makes more room
+        if (length > LINKTEST_CHUNK) length = LINKTEST_CHUNK;
+        if (length > LINKTEST_BYTES - linktest.result.sent) length = LINKTEST_BYTES - linktest.result.sent;
+
+        if (length) {
+            now = CYCCNT();
+            for (i = 0; i < length; i++) {
+                chunk[i] = LINKTEST_PATTERN(linktest.result.sent + i);
+                linktest.stamps[(linktest.result.sent + i) & LINKTEST_STAMP_MASK] = now;
+            }
+            UARTPort_put(&linktest.port, chunk, length);
+            linktest.result.sent += length;
+        }
+    }
+
+    while (buffer_size(&linktest.port.tx) != BUFFER_EMPTY ||
+           (UART_REG(linktest.port.base, UART_FR_OFFSET) & UART_FR_BUSY)) ;
+
+    DISABLE_IRQ();
+    if (linktest.expected < LINKTEST_BYTES) linktest.result.lost += LINKTEST_BYTES - linktest.expected;
+    linktest.result.line_errors = linktest.port.rx_errors;
+    *result = linktest.result;
+    ENABLE_IRQ();
+}
+
+/**
+ * @brief   RX callback of the loopback port, checks the pattern and records the byte's latency.
+ * @param   [in] port: loopback port.
+ * @param   [in] c: received byte.
+ * @details Runs in the UART4 interrupt handler.
+ *          A byte that doesn't match is looked for a few bytes ahead: if it's there, the bytes
+ *          in between were lost (and the pattern is resynced), otherwise the byte was corrupted.
+ */
+static void LinkTest_Receive(uart_port_t* port, char c)
+{
+    linktest_result_t* result = &linktest.result;
+    uint32_t now = CYCCNT(), latency, skip;
+    uint8_t bucket = 0;
+
+    (void)port;     // only one port runs the test
+
+    if ((uint8_t)c != LINKTEST_PATTERN(linktest.expected)) {
+        for (skip = 1; skip <= LINKTEST_RESYNC && (uint8_t)c != LINKTEST_PATTERN(linktest.expected + skip); skip++) ;
+
+        if (skip <= LINKTEST_RESYNC && linktest.expected + skip < result->sent) {
+            result->lost += skip;
+            linktest.expected += skip;
+        }
+        else {
+            result->mismatched++;
+        }
+    }
+
+    latency = (now - linktest.stamps[linktest.expected & LINKTEST_STAMP_MASK]) / LINKTEST_CYC_PER_US;
+    while (bucket < LINKTEST_BUCKETS - 1 && (latency >> (bucket + 1))) bucket++;
+    result->hist[bucket]++;
+    if (latency < result->lat_min) result->lat_min = latency;
+    if (latency > result->lat_max) result->lat_max = latency;
+
+    result->received++;
+    result->last_rx = now;
+    linktest.expected++;
+}
+
+/**
+ * @brief   Prints the results row of a baud rate.
+ */
+static void LinkTest_Report(uint32_t baud, linktest_result_t* result)
+{
+    char row_str[96];
+    uint32_t elapsed_ms_x16 = (result->last_rx - result->first_tx) / (F_CPU_CLK / 16000);
+    uint32_t bytes_per_s = elapsed_ms_x16 ? (result->received * 16000) / elapsed_ms_x16 : 0;
+    uint32_t eff_x10 = (bytes_per_s * 100) / (baud / 100);     // per mille of baud/10 bytes per second
+
+    if (result->received == 0) result->lat_min = 0;
+
+    sprintf(row_str, "%u,%u,%u.%u,%u,%u,%u,%u,%u,%u,%u\n", baud, bytes_per_s, eff_x10 / 10, eff_x10 % 10,
+            result->lat_min, LinkTest_Percentile(result, 50), LinkTest_Percentile(result, 99),
+            result->lat_max, result->mismatched, result->lost, result->line_errors);
+    UART0_puts(row_str);
+}
+
+/**
+ * @brief   Estimates a latency percentile from the histogram.
+ * @return  [uint32_t] Upper bound (us) of the bucket the percentile falls in.
+ */
+static uint32_t LinkTest_Percentile(linktest_result_t* result, uint32_t percent)
+{
+    uint32_t target = (result->received * percent + 99) / 100, count = 0;
+    uint8_t k;
+
+    for (k = 0; k < LINKTEST_BUCKETS; k++) {
+        count += result->hist[k];
+        if (count >= target && count) break;
+    }
+
+    return (k < LINKTEST_BUCKETS) ? ((uint32_t)2 << k) : result->lat_max;
+}
+
+/**
+ * @brief   Interrupt Handler for UART4 (link test loopback).
+ * @details Needs to be registered in the interrupt vector table, like UART0_IntHandler.
+ */
+void UART4_IntHandler(void)
+{
+    UARTPort_IntHandler(&linktest.port);
+}
@@ -0,0 +1,541 @@
+
+/**
+ * @file    macro.c
+ * @brief   Stored query macros: compiler and bytecode interpreter.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details A macro is typed in line by line after "macro def <name>", up to an "end" line.
+ *          Every line is either a query or one of the control statements:
+ *          - REPEAT [count] ... LOOP:  runs the body count times (forever if there's no count),
+ *          - IF OK|ERR ... [ELSE ...] FI: tests the result of the last query,
+ *          - WAIT <ticks>:             pauses for a number of tenths of a second.
+ * @details Lines are compiled as they come in: queries are looked up once and stored as
+ *          their query table index plus their set data, so running a macro never parses text again.
+ * @details "macro run <name>" hands the console to the interpreter, which runs from the main loop
+ *          (MACRO_STEPS instructions per update) until the macro ends or a key is pressed.
+ *          Macro queries aren't rate limited, the limits are there for the host link.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include "macro.h"
+#include "query_handler.h"
+#include "systime.h"
+#include "uart.h"
+
+#define MACRO_OPERAND(code, at) ((uint16_t)((code)[at] | ((code)[(at)+1] << 8)))
+
+static macro_store_t store;
+static macro_compiler_t compiler;
+static macro_vm_t vm;
+
+static bool Macro_Define(char* name);
+static bool Macro_Finish(void);
+static bool Macro_Block(char* keyword, char* args);
+static bool Macro_Emit(uint8_t op, const void* operand, uint16_t length);
+static void Macro_Patch(uint16_t at);
+static int8_t Macro_Find(char* name);
+static void Macro_Delete(uint8_t index);
+static void Macro_List(void);
+static void Macro_Dump(uint8_t index);
+static void Macro_Run(uint8_t index);
+static void Macro_Step(void);
+static void Macro_Stop(bool aborted);
+
+/**
+ * @brief   Initializes the macro storage and interpreter.
+ * @details Make sure systime has been initialized prior to calling this function,
+ *          WAIT instructions are timed by a systime tick hook.
+ */
+void Macro_Init(void)
+{
+    memset(&store, 0, sizeof(store));
+    compiler.en = false;
+    vm.en = false;
+
+    systime_AddTickHook(Macro_Tick);
+}
+
+/**
+ * @brief   Services the macro query.
+ * @param   [in] args: query set data (NULL if there is none). Supported forms:
+ *          - (none) or LIST: list the stored macros,
+ *          - DEF <name>: start defining a macro (replaces a macro with the same name once it's ended),
+ *          - RUN <name>: run a macro,
+ *          - DEL <name>: delete a macro,
+ *          - DUMP <name>: print a macro's bytecode in hex.
+ * @return  [bool] True if the arguments were valid.
+ */
+bool Macro_Query(char* args)
+{
+    char command[5], name[MACRO_NAME_LEN + 1], trailing;
+    int8_t index;
+
+    if (args == NULL || strcmp(args, "LIST") == 0) {
+        Macro_List();
+        return true;
+    }
+
+    if (sscanf(args, "%4s " MACRO_NAME_SCAN " %c", command, name, &trailing) != 2) {
+        return false;
+    }
+
+    if (strcmp(command, "DEF") == 0) {
+        return Macro_Define(name);
+    }
+
+    index = Macro_Find(name);
+    if (index < 0) {
+        return false;
+    }
+
+    if (strcmp(command, "RUN") == 0) {
+        Macro_Run(index);
+    }
+    else if (strcmp(command, "DEL") == 0) {
+        Macro_Delete(index);
+    }
+    else if (strcmp(command, "DUMP") == 0) {
+        Macro_Dump(index);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Determines if a macro is being defined (lines go to Macro_Line instead of being run).
+ */
+bool Macro_Defining(void)
+{
+    return compiler.en;
+}
+
+/**
+ * @brief   Compiles a line of the macro being defined.
+ * @param   [in] line: line from the query buffer (not null-terminated).
+ * @param   [in] length: line length.
+ * @return  [bool] True if the line was valid. Invalid lines are left out and the macro is discarded at its end.
+ */
+bool Macro_Line(char* line, uint32_t length)
+{
+    char line_str[CIRCULAR_BUFFER_SIZE + 1];
+    uint8_t operand[CIRCULAR_BUFFER_SIZE + 1];
+    char* keyword;
+    char* set_data;
+    int8_t index;
+    bool retval;
+
+    if (length == 0) return true;   // blank line (i.e. the second half of a CR-LF pair)
+    if (length > CIRCULAR_BUFFER_SIZE) length = CIRCULAR_BUFFER_SIZE;
+
+    memcpy(line_str, line, length);
+    QuerySplit(line_str, length, &keyword, &set_data);
+    compiler.lines++;
+
+    if (strcmp(keyword, "END") == 0) {
+        return Macro_Finish();
+    }
+
+    retval = Macro_Block(keyword, set_data);
+
+    if (!retval && (index = QueryFind(keyword)) >= 0 && QueryMacroAllowed(index)) {
+        operand[0] = index;
+
+        if (set_data == NULL) {
+            retval = Macro_Emit(MACRO_OP_QUERY, operand, 1);
+        }
+        else {
+            strcpy((char*)operand + 1, set_data);
+            retval = Macro_Emit(MACRO_OP_QUERY_SET, operand, strlen(set_data) + 2);
+        }
+    }
+
+    if (!retval) compiler.errors++;
+
+    return retval;
+}
+
+/**
+ * @brief   Determines if a macro currently owns the console.
+ */
+bool Macro_Running(void)
+{
+    return vm.en;
+}
+
+/**
+ * @brief   Macro interpreter update function, called from the main loop while a macro runs.
+ * @param   [in, out] rx_buf: console receive buffer.
+ * @details Runs up to MACRO_STEPS instructions (unless a WAIT is pending),
+ *          and aborts the macro if anything was typed on the console.
+ */
+void Macro_Update(circular_buffer_t* rx_buf)
+{
+    uint8_t steps;
+
+    if (buffer_size(rx_buf) != BUFFER_EMPTY) {
+        dequeue(rx_buf, NULL, buffer_size(rx_buf));
+        Macro_Stop(true);
+        return;
+    }
+
+    for (steps = 0; steps < MACRO_STEPS && vm.en && !vm.wait; steps++) {
+        Macro_Step();
+    }
+}
+
+/**
+ * @brief   Macro tick function.
+ * @details Registered as a systime tick hook, counts pending WAIT instructions down.
+ */
+void Macro_Tick(void)
+{
+    if (vm.wait) vm.wait--;
+}
+
+/**
+ * @brief   Starts defining a macro.
+ * @param   [in] name: macro name.
+ * @return  [bool] True if there's room for another macro (or the name already exists).
+ */
+static bool Macro_Define(char* name)
+{
+    if (Macro_Find(name) < 0 && store.count >= MACRO_MAX) {
+        return false;
+    }
+
+    memset(&compiler, 0, sizeof(compiler));
+    strcpy(compiler.name, name);
+    compiler.en = true;
+
+    return true;
+}
+
+/**
+ * @brief   Ends the macro definition, and stores the macro if it compiled cleanly.
+ * @return  [bool] True if the macro was stored.
+ * @details Reports "#MACRO <name> <bytecode length>", or "#MACRO <name> ERR <errors>" if it was discarded.
+ */
+static bool Macro_Finish(void)
+{
+    char report_str[48];
+    macro_t* macro;
+    int8_t index;
+    uint32_t replaced = 0;
+    bool retval = false;
+
+    compiler.en = false;
+
+    if (compiler.depth != 0) compiler.errors++;     // unterminated REPEAT or IF
+    if (!Macro_Emit(MACRO_OP_END, NULL, 0)) compiler.errors++;
+
+    if (compiler.errors == 0) {
+        // a macro being redefined is only deleted once the new one is known to fit
+        index = Macro_Find(compiler.name);
+        if (index >= 0) replaced = store.macros[index].length;
+
+        if (store.used - replaced + compiler.length <= MACRO_POOL_SIZE) {
+            if (index >= 0) Macro_Delete(index);
+
+            macro = &store.macros[store.count++];
+            strcpy(macro->name, compiler.name);
+            macro->offset = store.used;
+            macro->length = compiler.length;
+
+            memcpy(store.pool + store.used, compiler.code, compiler.length);
+            store.used += compiler.length;
+            retval = true;
+        }
+        else {
+            compiler.errors++;
+        }
+    }
+
+    if (retval) {
+        sprintf(report_str, "#MACRO %s %u\n", compiler.name, compiler.length);
+    }
+    else {
+        sprintf(report_str, "#MACRO %s ERR %u\n", compiler.name, compiler.errors);
+    }
+    UART0_puts(report_str);
+
+    return retval;
+}
+
+/**
+ * @brief   Compiles a control statement.
+ * @param   [in] keyword: statement keyword.
+ * @param   [in] args: statement arguments, NULL if there are none.
+ * @return  [bool] True if it was a valid control statement.
+ */
+static bool Macro_Block(char* keyword, char* args)
+{
+    macro_block_t* block = compiler.depth ? &compiler.blocks[compiler.depth - 1] : NULL;
+    unsigned int value = 0;
+    char trailing;
+    uint16_t operand = 0;
+    bool retval = false;
+
+    if (strcmp(keyword, "REPEAT") == 0) {
+        if (compiler.depth < MACRO_DEPTH &&
+            (args == NULL || (sscanf(args, "%u%c", &value, &trailing) == 1 && value > 0 && value <= UINT16_MAX))) {
+            operand = value;
+            retval = Macro_Emit(MACRO_OP_REPEAT, &operand, 2);
+            compiler.blocks[compiler.depth].op = MACRO_OP_REPEAT;
+            compiler.blocks[compiler.depth++].at = compiler.length;
+        }
+    }
+    else if (strcmp(keyword, "LOOP") == 0) {
+        if (args == NULL && block != NULL && block->op == MACRO_OP_REPEAT) {
+            retval = Macro_Emit(MACRO_OP_LOOP, &block->at, 2);
+            compiler.depth--;
+        }
+    }
+    else if (strcmp(keyword, "IF") == 0) {
+        if (compiler.depth < MACRO_DEPTH && args != NULL && (strcmp(args, "OK") == 0 || strcmp(args, "ERR") == 0)) {
+            retval = Macro_Emit((args[0] == 'O') ? MACRO_OP_IF_OK : MACRO_OP_IF_ERR, &operand, 2);
+            compiler.blocks[compiler.depth].op = MACRO_OP_IF_OK;
+            compiler.blocks[compiler.depth++].at = compiler.length - 2;
+        }
+    }
+    else if (strcmp(keyword, "ELSE") == 0) {
+        if (args == NULL && block != NULL && block->op == MACRO_OP_IF_OK) {
+            retval = Macro_Emit(MACRO_OP_JUMP, &operand, 2);
+            Macro_Patch(block->at);     // a failed IF lands right after the ELSE jump
+            block->op = MACRO_OP_JUMP;
+            block->at = compiler.length - 2;
+        }
+    }
+    else if (strcmp(keyword, "FI") == 0) {
+        if (args == NULL && block != NULL && block->op != MACRO_OP_REPEAT) {
+            Macro_Patch(block->at);
+            compiler.depth--;
+            retval = true;
+        }
+    }
+    else if (strcmp(keyword, "WAIT") == 0) {
+        if (args != NULL && sscanf(args, "%u%c", &value, &trailing) == 1 && value > 0 && value <= UINT16_MAX) {
+            operand = value;
+            retval = Macro_Emit(MACRO_OP_WAIT, &operand, 2);
+        }
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Appends an instruction to the macro being compiled.
+ * @param   [in] op: opcode.
+ * @param   [in] operand: operand bytes (16-bit operands in host order, which is little endian), NULL if none.
+ * @param   [in] length: operand length.
+ * @return  [bool] True if it fit (one byte is always kept for the final END).
+ */
+static bool Macro_Emit(uint8_t op, const void* operand, uint16_t length)
+{
+    uint16_t room = (op == MACRO_OP_END) ? MACRO_CODE_MAX : MACRO_CODE_MAX - 1;
+
+    if (compiler.length + 1 + length > room) {
+        return false;
+    }
+
+    compiler.code[compiler.length++] = op;
+    if (length) {
+        memcpy(compiler.code + compiler.length, operand, length);
+        compiler.length += length;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Points a jump operand at the end of the macro compiled so far.
+ * @param   [in] at: offset of the jump operand.
+ */
+static void Macro_Patch(uint16_t at)
+{
+    compiler.code[at] = compiler.length & 0xFF;
+    compiler.code[at+1] = compiler.length >> 8;
+}
+
+/**
+ * @brief   Finds a stored macro by name.
+ * @return  [int8_t] Index of the macro, -1 if there's no such macro.
+ */
+static int8_t Macro_Find(char* name)
+{
+    int8_t i;
+
+    for (i = 0; i < store.count; i++) {
+        if (strcmp(store.macros[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief   Deletes a stored macro, packing the pool and table back together.
+ * @param   [in] index: index of the macro.
+ */
+static void Macro_Delete(uint8_t index)
+{
+    macro_t* macro = &store.macros[index];
+    uint16_t offset = macro->offset, length = macro->length;
+    uint8_t i;
+
+    memmove(store.pool + offset, store.pool + offset + length, store.used - offset - length);
+    store.used -= length;
+
+    memmove(macro, macro + 1, (store.count - index - 1) * sizeof(macro_t));
+    store.count--;
+
+    for (i = 0; i < store.count; i++) {
+        if (store.macros[i].offset > offset) store.macros[i].offset -= length;
+    }
+}
+
+/**
+ * @brief   Prints the stored macros as "name,bytes" rows, then the free pool space.
+ */
+static void Macro_List(void)
+{
+    char row_str[32];
+    uint8_t i;
+
+    UART0_puts("name,bytes\n");
+    for (i = 0; i < store.count; i++) {
+        sprintf(row_str, "%s,%u\n", store.macros[i].name, store.macros[i].length);
+        UART0_puts(row_str);
+    }
+
+    sprintf(row_str, "#FREE %u\n", MACRO_POOL_SIZE - store.used);
+    UART0_puts(row_str);
+}
+
+/**
+ * @brief   Prints a macro's bytecode in hex, MACRO_DUMP_BYTES per line.
+ * @param   [in] index: index of the macro.
+ */
+static void Macro_Dump(uint8_t index)
+{
+    uint8_t* code = store.pool + store.macros[index].offset;
+    char byte_str[4];
+    uint16_t i;
+
+    for (i = 0; i < store.macros[index].length; i++) {
+        sprintf(byte_str, "%02X", code[i]);
+        UART0_puts(byte_str);
+        UART0_puts(((i + 1) % MACRO_DUMP_BYTES && (i + 1) != store.macros[index].length) ? " " : "\n");
+    }
+}
+
+/**
+ * @brief   Starts running a macro.
+ * @param   [in] index: index of the macro.
+ * @details Prints "#MACRO <name>", the macro's query replies follow.
+ */
+static void Macro_Run(uint8_t index)
+{
+    char start_str[24];
+
+    sprintf(start_str, "#MACRO %s\n", store.macros[index].name);
+    UART0_puts(start_str);
+
+    vm.code = store.pool + store.macros[index].offset;
+    vm.pc = 0;
+    vm.sp = 0;
+    vm.ok = true;
+    vm.wait = 0;
+    vm.queries = 0;
+    vm.errors = 0;
+    vm.en = true;
+}
+
+/**
+ * @brief   Runs a single macro instruction.
+ */
+static void Macro_Step(void)
+{
+    uint8_t* code = vm.code;
+    uint8_t op = code[vm.pc++];
+    uint16_t operand = 0;
+    uint8_t index;
+    char* set_data = NULL;
+
+    if (op != MACRO_OP_END && op != MACRO_OP_QUERY && op != MACRO_OP_QUERY_SET) {
+        operand = MACRO_OPERAND(code, vm.pc);
+        vm.pc += 2;
+    }
+
+    switch (op) {
+        case MACRO_OP_QUERY_SET:
+            set_data = (char*)code + vm.pc + 1;
+            /* no break */
+        case MACRO_OP_QUERY: {
+            index = code[vm.pc++];
+            if (set_data != NULL) vm.pc += strlen(set_data) + 1;
+
+            vm.ok = QueryRun(index, set_data);
+            vm.queries++;
+            if (!vm.ok) {
+                vm.errors++;
+                UART0_puts("? \n");
+            }
+        } break;
+
+        case MACRO_OP_REPEAT: {
+            vm.counters[vm.sp++] = operand;
+        } break;
+
+        case MACRO_OP_LOOP: {
+            // a count of 0 loops forever
+            if (vm.counters[vm.sp-1] == 0 || --vm.counters[vm.sp-1] != 0) {
+                vm.pc = operand;
+            }
+            else {
+                vm.sp--;
+            }
+        } break;
+
+        case MACRO_OP_IF_OK: {
+            if (!vm.ok) vm.pc = operand;
+        } break;
+
+        case MACRO_OP_IF_ERR: {
+            if (vm.ok) vm.pc = operand;
+        } break;
+
+        case MACRO_OP_JUMP: {
+            vm.pc = operand;
+        } break;
+
+        case MACRO_OP_WAIT: {
+            vm.wait = operand;
+        } break;
+
+        default: {
+            Macro_Stop(false);
+        } break;
+    }
+}
+
+/**
+ * @brief   Stops the running macro and gives the console back.
+ * @param   [in] aborted: True if the macro was stopped by a key press.
+ * @details Prints "#END <queries> ERR <failed queries>" (with " ABORT" if it was stopped early) and a prompt.
+ */
+static void Macro_Stop(bool aborted)
+{
+    char summary_str[48];
+
+    vm.en = false;
+
+    sprintf(summary_str, "#END %u ERR %u%s\n> ", vm.queries, vm.errors, aborted ? " ABORT" : "");
+    UART0_puts(summary_str);
+}
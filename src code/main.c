@@ -43,6 +43,91 @@
  *
  *              Clear alarm Query: <alarm>. \n
  *              Set Alarm Query: <alarm hh:mm:ss.t> (all values are decimal)
+ *
+ *              Bulk Mode Query: <bulk>. \n
+ *              Turns echo and prompts off for pasting/uploading scripts of queries.
+ *              Lines are acknowledged in batches as "#ACK <lines> OK <n> ERR <n> [: <failed line numbers>]",
+ *              and the <end> query leaves bulk mode with a "#END <lines> ERR <n>" summary.
+ *              Diagnostic queries aren't run in bulk mode, their lines count as failed.
+ *
+ *              Benchmark Query: <bench>. \n
+ *              Runs on-device microbenchmarks (cycle counts via the DWT cycle counter)
+ *              and prints them as a "name,len,iters,cyc_per_op" table between "#BENCH" and "#END".
+ *
+ *              Sniffer Query: <sniff>. \n
+ *              Bridges UART2 (PA6/PA7) and UART3 (PA4/PA5) at 115200 baud and streams every bridged byte
+ *              after a "#SNIFF" line as binary 4-byte records: [0xA0 | direction][16-bit LE delta in us][byte].
+ *              Direction 0 is UART2 -> UART3. Any key stops it, with a "#END <records> DROP <dropped> FWD <dropped> ERR <errors>" summary
+ *              (capture records the console couldn't keep up with, bridged bytes lost to a full TX buffer,
+ *              line errors on either side, which lose bytes that are neither bridged nor captured).
+ *              At a 115200 console the capture keeps up with about 2880 bridged bytes/s, a quarter of one direction.
+ *              <sniff z> sends the records LZ compressed instead (see below).
+ *
+ *              Interrupt Monitor Query: <irqmon>. \n
+ *              Reports edge counts, rate over the last second, min/max inter-arrival time (us)
+ *              and missed-edge estimates for PL0..PL3 (both edges).
+ *              <irqmon reset> clears the statistics, <irqmon log on|off> enables the edge log,
+ *              <irqmon dump> prints the logged edges, and <irqmon sim pin edges period_us> injects simulated edges
+ *              (up to 10000 edges, periods up to 268 s).
+ *              <irqmon dump z> sends the log LZ compressed, as 5-byte records whose stamp is the cycles since the previous record.
+ *
+ *              Link Test Query: <linktest> or <linktest baud>. \n
+ *              Runs UART4 in internal loopback and pushes 1024 patterned bytes through the driver (rings, interrupt handler, FIFOs)
+ *              at every baud rate from 9600 to 921600 (or the one given). Reports throughput, byte latency (min/p50/p99/max),
+ *              pattern mismatches, lost bytes and line errors per rate, then a latency histogram, between "#LINKTEST" and "#END".
+ *
+ *              Baud Query: <baud>, <baud ok>, <baud auto on|off>, <baud rate>. \n
+ *              Reports the console baud rate, the fallback policy state and the line error counters
+ *              (overrun, break, parity, framing). Bytes received with break/parity/framing errors are discarded.
+ *              With auto on (the default), 3 seconds in a row with 4+ line errors each step the rate down
+ *              (115200, 57600, 38400, 19200, 9600), and a minute without errors steps it back up.
+ *              Every change is announced as "#BAUD <rate>" at the old rate; the host has to switch and send <baud ok>
+ *              within 5 seconds, or the board goes back with a "#BAUD <rate> REVERT" at the old rate.
+ *              <baud rate> changes the rate by hand, with the same handshake.
+ *
+ *              Boot Profile Query: <boot>. \n
+ *              Reports when each initialization phase completed, from main to the first prompt and first query,
+ *              as "phase,us,delta_us" rows.
+ *
+ *              Statistics Query: <stats>. \n
+ *              Reports the session's query, error, throttled-line and deferred-update counts and dropped RX bytes.
+ *              Queries are rate limited (overall and per display/set/diagnostic class), lines over their limit
+ *              are dropped with a "#THROTTLED" reply.
+ *
+ *              Top Query: <top> or <top period>. \n
+ *              Takes over the terminal with a live view of per-interrupt call rate, time per call and load,
+ *              total interrupt load and main loop rate, ring occupancy and high-water marks,
+ *              the alarm and the last queries. Refreshes every period tenths of a second (default 10),
+ *              only sending the cells that changed. Any key closes it.
+ *
+ *              Macro Query: <macro def name>, <macro run name>, <macro del name>, <macro dump name>, <macro [list]>. \n
+ *              <macro def name> records the following lines as a macro, up to an <end> line.
+ *              Lines are queries or the control statements <repeat [count]> ... <loop>,
+ *              <if ok|err> ... [<else> ...] <fi> (testing the last query's result) and <wait tenths>.
+ *              Macros are compiled to bytecode as they're typed in, and stored in RAM (lost on reset).
+ *              <macro run name> runs a macro from the main loop until it ends or any key is pressed,
+ *              followed by a "#END <queries> ERR <n>" summary. bulk, end, macro, baud and the diagnostic queries (bench, sniff, irqmon, boot, top, linktest, postmortem) can't be used in macros.
+ *
+ *              Postmortem Query: <postmortem>, <postmortem clear>, <postmortem reboot>. \n
+ *              Dumps the flight recorder left by the previous run: its last 64 trace events (queries, alarm callbacks,
+ *              baud changes) and, if it was sealed, the active exceptions, interrupt counts, line error counters and
+ *              the console RX/TX buffers. The recorder is kept in no-init RAM, so it survives any reset but a power cycle.
+ *              It's sealed by the watchdog (the main loop not going around for 4 seconds, it resets the board 4 seconds later)
+ *              and by <postmortem reboot>, which resets the board on purpose. FlightRec_NmiHandler goes in the NMI vector.
+ *
+ *              Tunables Queries: <list>, <get name>, <set name value>, <set save>, <set defaults>. \n
+ *              Performance settings that used to be compile-time constants, each with a range and a default:
+ *              SysTick trim (ppm), UART0 RX/TX FIFO interrupt levels, echo, query budget and rate limit,
+ *              sniffer compression chunk, baud fallback thresholds and watchdog time-out.
+ *              <set> applies a value right away. <set save> stores the current values in the EEPROM,
+ *              where they're loaded from on every boot, <set defaults> goes back to the defaults (until saved).
+ *
+ * @section     Compressed Streams
+ *              Compressed streams start after a "#LZ" line and end with a 0xFF byte (before the usual "#END" line).
+ *              They can be unpacked with the decoder under "host tools": lz_decompress < capture.bin > records.bin
+ *              <sniff z> packs each chunk of records before compressing it (see Bridge_Pack()),
+ *              lz_decompress -s unpacks them back into records.
+ *              lz_decompress -i turns the delta stamps of <irqmon dump z> back into cycle counter values.
  */
 
 
@@ -51,6 +136,14 @@
 #include "systick.h"
 #include "systime.h"
 #include "query_handler.h"
+#include "bridge.h"
+#include "irqmon.h"
+#include "boot.h"
+#include "top.h"
+#include "macro.h"
+#include "baud.h"
+#include "flightrec.h"
+#include "tunables.h"
 
 /**
  * @brief   Entry point to the monitor program
@@ -59,15 +152,42 @@ int main(void)
 {
     uart_descriptor_t uart = {.echo = true};    // initialize uart descriptor.
 
+    Boot_Start();           // start the boot profile.
+
     UART0_Init(&uart);      // initialize uart driver.
+    Boot_Mark(BOOT_UART_INIT);
     systime_init();         // initialize systime.
-    QueryHandler_Init();    // initialize the Query Handler.
+    Boot_Mark(BOOT_SYSTIME_INIT);
+    FlightRec_Init(&uart);  // pick up the previous run's flight recorder, start recording (and the watchdog).
+    Tunables_Init();        // load the saved tunables (or the defaults) and apply them.
+    IrqMon_Init();          // initialize the external interrupt monitor.
+    Boot_Mark(BOOT_IRQMON_INIT);
+
+    SysTick_Start();        // start keeping time before anything is sent out.
+    Boot_Mark(BOOT_SYSTICK_START);
 
-    SysTick_Start();
+    Top_Init();             // initialize the top view (off until queried).
+    Macro_Init();           // initialize the macro storage and interpreter.
+    Baud_Init();            // initialize the console baud rate fallback policy.
+    QueryHandler_Init();    // initialize the Query Handler (the banner is only queued).
+    Boot_Mark(BOOT_QUERY_INIT);
 
 
     while (1) {
-        if (buffer_size(&uart.rx)) {
+        Boot_Update();
+        Baud_Update();
+        FlightRec_Update();
+
+        if (Bridge_Sniffing()) {
+            Bridge_Update(&uart.rx);
+        }
+        else if (Top_Running()) {
+            Top_Update(&uart);
+        }
+        else if (Macro_Running()) {
+            Macro_Update(&uart.rx);
+        }
+        else {
             QueryHandler_Update(&uart.rx);
         }
     }
@@ -4,7 +4,7 @@
  * @brief   Defines all the functionality regarding query handling of the monitor.
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.10 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  */
 
 
@@ -12,19 +12,80 @@
 #include <string.h>
 #include <ctype.h>
 #include "query_handler.h"
+#include "bench.h"
+#include "bridge.h"
+#include "irqmon.h"
+#include "boot.h"
+#include "top.h"
+#include "macro.h"
+#include "linktest.h"
+#include "baud.h"
+#include "flightrec.h"
+#include "tunables.h"
 #include "uart.h"
 
-/** All valid month entries for setting the date*/
-static const char* const MONTHS[] = {
-    "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
-    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
-};
-
 /* all supported query keywords */
 
 const char TIME_QUERY[] = {"TIME"};     /// Time query keyword
 const char DATE_QUERY[] = {"DATE"};     /// Date query keyword
 const char ALARM_QUERY[] = {"ALARM"};   /// Alarm query keyword
+const char BULK_QUERY[] = {"BULK"};     /// Bulk mode query keyword
+const char BULK_END_QUERY[] = {"END"};  /// Bulk mode terminating keyword
+const char BENCH_QUERY[] = {"BENCH"};   /// Microbenchmark query keyword
+const char SNIFF_QUERY[] = {"SNIFF"};   /// UART bridge/sniffer query keyword
+const char IRQMON_QUERY[] = {"IRQMON"}; /// External interrupt monitor query keyword
+const char BOOT_QUERY[] = {"BOOT"};     /// Boot profile query keyword
+const char STATS_QUERY[] = {"STATS"};   /// Session statistics query keyword
+const char TOP_QUERY[] = {"TOP"};       /// Live top view query keyword
+const char MACRO_QUERY[] = {"MACRO"};   /// Macro definition/execution query keyword
+const char LINKTEST_QUERY[] = {"LINKTEST"}; /// UART loopback self-test query keyword
+const char BAUD_QUERY[] = {"BAUD"};     /// Console baud rate/line error query keyword
+const char POSTMORTEM_QUERY[] = {"POSTMORTEM"}; /// Flight recorder dump query keyword
+const char GET_QUERY[] = {"GET"};       /// Tunable report query keyword
+const char SET_QUERY[] = {"SET"};       /// Tunable change/save query keyword
+const char LIST_QUERY[] = {"LIST"};     /// Tunables listing query keyword
+
+/* query handlers (set data in, validity out) */
+static bool TimeQuery(char* set_data);
+static bool DateQuery(char* set_data);
+static bool AlarmQuery(char* set_data);
+static bool BulkQuery(char* set_data);
+static bool BulkEndQuery(char* set_data);
+static bool BenchQuery(char* set_data);
+static bool SniffQuery(char* set_data);
+static bool BootQuery(char* set_data);
+static bool StatsQuery(char* set_data);
+
+/**
+ * @brief   Query table.
+ * @details Queries that take over the console (or change how lines are handled) can't run from a macro.
+ */
+static const query_entry_t QUERIES[] = {
+    {TIME_QUERY,        TimeQuery,      true},
+    {DATE_QUERY,        DateQuery,      true},
+    {ALARM_QUERY,       AlarmQuery,     true},
+    {BULK_QUERY,        BulkQuery,      false},
+    {BULK_END_QUERY,    BulkEndQuery,   false},
+    {BENCH_QUERY,       BenchQuery,     false},
+    {SNIFF_QUERY,       SniffQuery,     false},
+    {IRQMON_QUERY,      IrqMon_Query,   false},
+    {BOOT_QUERY,        BootQuery,      false},
+    {STATS_QUERY,       StatsQuery,     true},
+    {TOP_QUERY,         Top_Query,      false},
+    {MACRO_QUERY,       Macro_Query,    false},
+    {LINKTEST_QUERY,    LinkTest_Query, false},
+    {BAUD_QUERY,        Baud_Query,     false},
+    {POSTMORTEM_QUERY,  FlightRec_Query, false},
+    {GET_QUERY,         Tunables_GetQuery,  true},
+    {SET_QUERY,         Tunables_SetQuery,  true},
+    {LIST_QUERY,        Tunables_ListQuery, true},
+};
+
+#define QUERY_COUNT ((int8_t)(sizeof(QUERIES)/sizeof(QUERIES[0])))
+
+/** Keywords of the QUERY_CLASS_DIAG queries, these can't run from macros or bulk mode, which aren't rate limited */
+static const char* const DIAG_QUERIES[] = {BENCH_QUERY, SNIFF_QUERY, IRQMON_QUERY, BOOT_QUERY, TOP_QUERY, LINKTEST_QUERY,
+                                            POSTMORTEM_QUERY};
 
 char CURSOR_LEFT[] = {"\x1b[D"};
 char CURSOR_RIGHT[] = {"\x1b[C"};
@@ -32,22 +93,41 @@ char CURSOR_UP[] = {"\x1b[A"};
 char CURSOR_DOWN[] = {"\x1b[B"};
 char CLEAR_SCREEN[] = {"\x1b[2J"};
 char CURSOR_HOME[] = {"\x1b[H"};
+char CURSOR_HIDE[] = {"\x1b[?25l"};
+char CURSOR_SHOW[] = {"\x1b[?25h"};
 char ALARM_BELL[] = {"\x07"};
 
-// This function is only needed in this module so no need to make it available elsewhere.
+// These functions are only needed in this module so no need to make them available elsewhere.
 uint8_t FindMonthValue(char* month_str);
+static void QueryReply(char* str);
+static void BulkLine(void);
+static void BulkAck(void);
+static bool QueryLine(void);
+static bool QueryAllow(void);
+static uint8_t QueryClassify(void);
+static char* QueryRecord(void);
 
 static query_buffer_t query; /** Query character buffer */
+static bulk_session_t bulk;  /** Bulk mode session */
+static query_session_t session; /** Terminal session rate limits & stats */
 
 /**
  * @brief   Initializes the query handler's buffer and the terminal entry point.
  * @details Make sure the UART driver has been initialized prior to calling this function,
  *          otherwise you will cause a memory access fault.
+ * @details The banner fits in the TX buffer, so it is only queued and this doesn't wait on the UART.
+ * @details Make sure systime has been initialized too, the rate limits are refilled by a tick hook.
  */
 void QueryHandler_Init()
 {
     circular_buffer_init(&query.buffer);
 
+    token_bucket_init(&session.limit, Tunables_Get(TUNE_QUERY_BURST), Tunables_Get(TUNE_QUERY_PERIOD));
+    token_bucket_init(&session.class_limit[QUERY_CLASS_DISPLAY], DISPLAY_RATE_BURST, DISPLAY_RATE_PERIOD);
+    token_bucket_init(&session.class_limit[QUERY_CLASS_SET], SET_RATE_BURST, SET_RATE_PERIOD);
+    token_bucket_init(&session.class_limit[QUERY_CLASS_DIAG], DIAG_RATE_BURST, DIAG_RATE_PERIOD);
+    systime_AddTickHook(QueryHandler_Tick);
+
     UART0_puts(CLEAR_SCREEN);
     UART0_puts(CURSOR_HOME);
     UART0_puts("> ");
@@ -59,107 +139,413 @@ void QueryHandler_Init()
  * @details This function normally just transfers bytes from the RX buffer to the query buffer,
  *          but checks for certain key characters that effect the behavior of the query buffer,
  *          namely the delete/backspace char, the ENTER char, and the start of an ANSI escape code.
+ * @details Each call is bounded: at most QUERY_BUDGET characters (a tunable) and one query are serviced,
+ *          anything left over waits for the next call, so a chatty client can't hog the main loop.
+ *          A line that is over its rate limit is dropped with a "#THROTTLED" reply, the RX buffer keeps draining.
  */
 void QueryHandler_Update(circular_buffer_t* rx_buf)
 {
-    char data = dequeuec(rx_buf);
+    uint32_t budget = Tunables_Get(TUNE_QUERY_BUDGET);
+    char data;
 
-    switch (data) {
-        case '\b':
-        case 0x7F: {
-            if (query.buffer.wr_ptr > 0) {
-                query.buffer.wr_ptr--;
-                query.entry_ptr--;
-            }
-            else {
-                UART0_puts(" ");
-            }
-        } break;
+    while (budget && buffer_size(rx_buf) != BUFFER_EMPTY) {
+        budget--;
+        data = dequeuec(rx_buf);
 
-        case '\r':
-        case '\n': {
-//            enqueuec_s(&query.buffer, toupper(data), false);
-            if (!QueryCheck(query.buffer.data, query.buffer.wr_ptr)) {
-                UART0_puts("? \n");
+        if (query.esc_len) {
+            CursorCodeCheck(data);
+            continue;
+        }
+
+        switch (data) {
+            case '\b':
+            case 0x7F: {
+                if (query.buffer.wr_ptr > 0) {
+                    query.buffer.wr_ptr--;
+                    query.entry_ptr--;
+                }
+                else {
+                    QueryReply(" ");
+                }
+            } break;
+
+            case '\r':
+            case '\n': {
+                QueryLine();
+                return;
             }
-//            memset(query.buffer.data, 0, query.entry_ptr);
-            query.entry_ptr = 0;
-            query.buffer.wr_ptr = 0;
 
-            UART0_puts("> ");
-        } break;
+            case 0x1B: {
+                query.esc_len = 1;  // the rest of the code goes to CursorCodeCheck()
+            } break;
 
-        case 0x1B: {
-            CursorCodeCheck(rx_buf);
-        } break;
+            default: {
+                if (!enqueuec_s(&query.buffer, toupper(data), false)) QueryReply("\b");
+                if (query.entry_ptr < query.buffer.wr_ptr) query.entry_ptr = query.buffer.wr_ptr;
+            } break;
+        }
+    }
 
-        default: {
-            if (!enqueuec_s(&query.buffer, toupper(data), false)) UART0_puts("\b");
-            if (query.entry_ptr < query.buffer.wr_ptr) query.entry_ptr = query.buffer.wr_ptr;
-        } break;
+    if (buffer_size(rx_buf) != BUFFER_EMPTY) {
+        session.yields++;
     }
 }
 
 /**
- * @brief   Checks the data currently in the Query buffer for a valid query
- *          and services valid queries.
- * @return  [bool] True if there is a valid query in the buffer, False in not.
+ * @brief   Query Handler tick function.
+ * @details Registered as a systime tick hook to refill the session's rate limits.
  */
-bool QueryCheck()
+void QueryHandler_Tick(void)
 {
-    bool valid_command = false;
+    uint8_t i;
+
+    token_bucket_tick(&session.limit);
+    for (i = 0; i < QUERY_CLASS_COUNT; i++) {
+        token_bucket_tick(&session.class_limit[i]);
+    }
+}
+
+/**
+ * @brief   Sets the session's overall rate limit.
+ * @param   [in] burst: queries allowed in a burst.
+ * @param   [in] period: ticks per query refilled (1 / sustained rate).
+ * @details The bucket starts over full. The tick refills it from the SysTick interrupt, so it's swapped with interrupts masked.
+ */
+void QueryHandler_SetRateLimit(uint16_t burst, uint16_t period)
+{
+    DISABLE_IRQ();
+    token_bucket_init(&session.limit, burst, period);
+    ENABLE_IRQ();
+}
+
+/**
+ * @brief   Services a complete line in the query buffer (the ENTER char was received).
+ * @return  [bool] True if the line was serviced, false if it was over its rate limit and dropped.
+ */
+static bool QueryLine(void)
+{
+    bool valid_command;
+    bool allowed = QueryAllow();
+    char* history_entry;
+
+//    enqueuec_s(&query.buffer, toupper(data), false);
+    if (!allowed) {
+        session.throttled++;
+        QueryReply("#THROTTLED\n");
+    }
+    else if (Macro_Defining()) {
+        if (!Macro_Line(query.buffer.data, query.entry_ptr)) QueryReply("? \n");
+    }
+    else if (bulk.en) {
+        BulkLine();
+    }
+    else {
+        history_entry = QueryRecord();
+        valid_command = QueryCheck();
+        session.queries++;
+
+        if (!valid_command) {
+            if (history_entry != NULL) history_entry[0] = '?';
+            session.errors++;
+            QueryReply("? \n");
+        }
+    }
+    Boot_Mark(BOOT_FIRST_QUERY);
+//    memset(query.buffer.data, 0, query.entry_ptr);
+    query.entry_ptr = 0;
+    query.buffer.wr_ptr = 0;
+
+    // the sniffer, top view and macros own the console until they're done, and prompt when they are
+    if (!Bridge_Sniffing() && !Top_Running() && !Macro_Running()) {
+        QueryReply("> ");
+    }
+
+    return allowed;
+}
+
+/**
+ * @brief   Keeps a copy of the line in the query buffer in the query history.
+ * @return  [char*] The history entry ("  <line>", truncated to fit), NULL for a blank line.
+ * @details Must be called before QueryCheck(), which splits the line up.
+ */
+static char* QueryRecord(void)
+{
+    char* entry;
+    uint32_t length = query.entry_ptr;
+
+    if (length == 0) return NULL;
+    if (length > QUERY_HISTORY_LEN - 3) length = QUERY_HISTORY_LEN - 3;
+
+    session.history_head = (session.history_head + 1) % QUERY_HISTORY;
+    entry = session.history[session.history_head];
+
+    entry[0] = ' ';
+    entry[1] = ' ';
+    memcpy(entry + 2, query.buffer.data, length);
+    entry[length + 2] = '\0';
+
+    return entry;
+}
+
+/**
+ * @brief   Gets a query from the history.
+ * @param   [in] age: 0 for the most recent query, up to QUERY_HISTORY-1.
+ * @return  [const char*] The query, prefixed with "? " if it failed (empty if there's none).
+ */
+const char* QueryHistory(uint8_t age)
+{
+    return session.history[(session.history_head + QUERY_HISTORY - age) % QUERY_HISTORY];
+}
 
-    // Make these equivalences just to improve readability
-    // I made my animal sacrifices to ensure the gcc compiler gods will optimize this
+/**
+ * @brief   Applies the session rate limits to the line in the query buffer.
+ * @return  [bool] True if the line can be serviced now (its tokens are taken), false if not.
+ * @details Bulk mode lines, macro definition lines and blank lines aren't rate limited,
+ *          bulk mode is an explicit request to go at line rate (and macro lines aren't run).
+ *          Diagnostic queries are refused in bulk mode and in macros instead, they'd bypass their limit there.
+ */
+static bool QueryAllow(void)
+{
+    bool retval = true;
+    token_bucket_t* class_limit;
+
+    if (!bulk.en && !Macro_Defining() && query.entry_ptr != 0) {
+        class_limit = &session.class_limit[QueryClassify()];
+
+        DISABLE_IRQ();
+        retval = token_bucket_available(&session.limit) && token_bucket_available(class_limit);
+        if (retval) {
+            token_bucket_take(&session.limit);
+            token_bucket_take(class_limit);
+        }
+        ENABLE_IRQ();
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Finds the class of the query in the query buffer, without modifying it.
+ * @return  [uint8_t] Query class (see QUERY_CLASSES).
+ */
+static uint8_t QueryClassify(void)
+{
     char* query_str = query.buffer.data;
     uint32_t length = query.entry_ptr;
+    uint32_t i = 0, start, keyword_len, q;
+
+    while (i < length && query_str[i] == ' ') i++;
+    start = i;
+    while (i < length && query_str[i] != ' ') i++;
+    keyword_len = i - start;
+    while (i < length && query_str[i] == ' ') i++;
+
+    for (q = 0; q < sizeof(DIAG_QUERIES)/sizeof(DIAG_QUERIES[0]); q++) {
+        if (strlen(DIAG_QUERIES[q]) == keyword_len && memcmp(query_str+start, DIAG_QUERIES[q], keyword_len) == 0) {
+            return QUERY_CLASS_DIAG;
+        }
+    }
+
+    return (i < length) ? QUERY_CLASS_SET : QUERY_CLASS_DISPLAY;
+}
 
+/**
+ * @brief   Checks the data currently in the Query buffer for a valid query
+ *          and services valid queries.
+ * @return  [bool] True if there is a valid query in the buffer, False in not.
+ */
+bool QueryCheck()
+{
     char* keyword;
     char* set_data;
+    int8_t index;
+
+    QuerySplit(query.buffer.data, query.entry_ptr, &keyword, &set_data);
+    index = QueryFind(keyword);
+
+    return (index >= 0) ? QueryRun(index, set_data) : false;
+}
+
+/**
+ * @brief   Splits a query entry into its keyword and set data, in place.
+ * @param   [in, out] query_str: query entry, must have room for a null char at query_str[length].
+ * @param   [in] length: length of the query entry.
+ * @param   [out] keyword: where the pointer to the (null-terminated) keyword is written.
+ * @param   [out] set_data: where the pointer to the (null-terminated) set data is written, NULL if there's none.
+ */
+void QuerySplit(char* query_str, uint32_t length, char** keyword, char** set_data)
+{
+    uint32_t i = 0;
+
+    query_str[length] = '\0';  // the buffer past the entry still holds older (longer) entries
 
-    int i = 0;
     // Find the begin of they query entry
-    while (i <= length && query_str[i] == ' ') i++;
-    keyword = query_str + i;
+    while (i < length && query_str[i] == ' ') i++;
+    *keyword = query_str + i;
 
     // Find the end of the query keyword
     while (i < length && query_str[i] != ' ') i++;
-    query_str[i++] = '\0';    // null-terminate the keyword to make decoding easier.
+    if (i < length) query_str[i++] = '\0';    // null-terminate the keyword to make decoding easier.
 
     // Find the begin of the query set data (if it exists)
     while (i < length && query_str[i] == ' ') i++;
-    set_data = (i < length) ? (query_str + i) : NULL;
+    *set_data = (i < length) ? (query_str + i) : NULL;
+}
 
-    if (strcmp(keyword, TIME_QUERY) == 0) {
-        if (set_data != NULL) {
-            valid_command = SetTime(set_data);
-        }
-        else {
-            DisplayTime();
-            valid_command = true;
-        }
-    }
-    else if (strcmp(keyword, DATE_QUERY) == 0) {
-        if (set_data != NULL) {
-            valid_command = SetDate(set_data);
-        }
-        else {
-            DisplayDate();
-            valid_command = true;
-        }
-    }
-    else if(strcmp(keyword, ALARM_QUERY) == 0) {
-        if (set_data != NULL) {
-            valid_command = SetAlarm(set_data);
-        }
-        else {
-            systime_ClearAlarm();
-            UART0_puts("Alarm has been cleared\n");
-            valid_command = true;
+/**
+ * @brief   Finds a query by its keyword.
+ * @param   [in] keyword: null-terminated query keyword.
+ * @return  [int8_t] Index of the query in the query table, -1 if there's no such query.
+ */
+int8_t QueryFind(char* keyword)
+{
+    int8_t i;
+
+    for (i = 0; i < QUERY_COUNT; i++) {
+        if (strcmp(keyword, QUERIES[i].keyword) == 0) {
+            return i;
         }
     }
 
-    return valid_command;
+    return -1;
+}
+
+/**
+ * @brief   Determines if a query can be run from a macro.
+ * @param   [in] index: index of the query in the query table.
+ */
+bool QueryMacroAllowed(uint8_t index)
+{
+    return QUERIES[index].macro_ok;
+}
+
+/**
+ * @brief   Services a query that has already been decoded.
+ * @param   [in] index: index of the query in the query table (see QueryFind).
+ * @param   [in] set_data: null-terminated set data, NULL if there's none.
+ * @return  [bool] True if the query was valid and serviced.
+ */
+bool QueryRun(uint8_t index, char* set_data)
+{
+    bool valid;
+
+    FlightRec_Trace(FLIGHTREC_QUERY, index, 0);
+    valid = QUERIES[index].handler(set_data);
+    FlightRec_Trace(FLIGHTREC_QUERY_END, index, valid);
+
+    return valid;
+}
+
+/**
+ * @brief   Gets the keyword of a query.
+ * @param   [in] index: index of the query in the query table.
+ * @return  [const char*] Query keyword, NULL if there's no such query.
+ */
+const char* QueryKeyword(uint8_t index)
+{
+    return (index < QUERY_COUNT) ? QUERIES[index].keyword : NULL;
+}
+
+/**
+ * @brief   Time query handler: sets the time, or displays it if there's no set data.
+ */
+static bool TimeQuery(char* set_data)
+{
+    if (set_data != NULL) return SetTime(set_data);
+
+    DisplayTime();
+    return true;
+}
+
+/**
+ * @brief   Date query handler: sets the date, or displays it if there's no set data.
+ */
+static bool DateQuery(char* set_data)
+{
+    if (set_data != NULL) return SetDate(set_data);
+
+    DisplayDate();
+    return true;
+}
+
+/**
+ * @brief   Alarm query handler: sets the alarm, or clears it if there's no set data.
+ */
+static bool AlarmQuery(char* set_data)
+{
+    if (set_data != NULL) return SetAlarm(set_data);
+
+    systime_ClearAlarm();
+    QueryReply("Alarm has been cleared\n");
+    return true;
+}
+
+/**
+ * @brief   Bulk query handler: enters bulk mode.
+ */
+static bool BulkQuery(char* set_data)
+{
+    (void)set_data;
+
+    if (!bulk.en) BulkStart();
+    return true;
+}
+
+/**
+ * @brief   End query handler: leaves bulk mode (only valid in bulk mode).
+ */
+static bool BulkEndQuery(char* set_data)
+{
+    (void)set_data;
+
+    if (!bulk.en) return false;
+
+    BulkEnd();
+    return true;
+}
+
+/**
+ * @brief   Bench query handler: runs the microbenchmarks.
+ */
+static bool BenchQuery(char* set_data)
+{
+    (void)set_data;
+
+    Bench_Run();
+    return true;
+}
+
+/**
+ * @brief   Sniff query handler: starts the sniffer, LZ compressed with the "Z" set data.
+ */
+static bool SniffQuery(char* set_data)
+{
+    if (set_data != NULL && strcmp(set_data, "Z") != 0) return false;
+
+    Bridge_Start(set_data != NULL);
+    return true;
+}
+
+/**
+ * @brief   Boot query handler: reports the boot profile.
+ */
+static bool BootQuery(char* set_data)
+{
+    (void)set_data;
+
+    Boot_Report();
+    return true;
+}
+
+/**
+ * @brief   Stats query handler: reports the session statistics.
+ */
+static bool StatsQuery(char* set_data)
+{
+    (void)set_data;
+
+    DisplayStats();
+    return true;
 }
 
 /**
@@ -175,19 +561,19 @@ bool SetTime(char* new_time_str)
     bool retval = false;
     char time_str[128];
 
-    int scan_res = sscanf(new_time_str, "%2hhu:%2hhu:%2hhu.%1hhu",
+    int scan_res = sscanf(new_time_str, TIME_SCAN_FORMAT,
                           &clock_temp.hour, &clock_temp.min,
                           &clock_temp.sec, &clock_temp.t_sec);
 
     if (scan_res == VALID_TIME_SCAN && systime_SetTime(&clock_temp)) {
         retval = true;
 
-        sprintf(time_str, "%02u:%02u:%02u.%u",
+        sprintf(time_str, TIME_PRINT_FORMAT,
                 clock_temp.hour, clock_temp.min,
                 clock_temp.sec, clock_temp.t_sec);
 
-        UART0_puts(time_str);
-        UART0_puts(" \n");
+        QueryReply(time_str);
+        QueryReply(" \n");
     }
 
     return retval;
@@ -198,16 +584,25 @@ bool SetTime(char* new_time_str)
  */
 void DisplayTime(void)
 {
+#if SYSTIME_ASCII_CLOCK
+    char time_str[SYSTIME_CLOCK_STR_LEN + sizeof(" \n")];
+
+    systime_GetTimeStr(time_str);
+    memcpy(time_str + SYSTIME_CLOCK_STR_LEN, " \n", sizeof(" \n"));
+
+    QueryReply(time_str);
+#else
     clock_t clock_temp;
     systime_GetTime(&clock_temp);
 
     char time_str[128];
-    sprintf(time_str, "%02u:%02u:%02u.%u",
+    sprintf(time_str, TIME_PRINT_FORMAT,
             clock_temp.hour, clock_temp.min,
             clock_temp.sec, clock_temp.t_sec);
 
-    UART0_puts(time_str);
-    UART0_puts(" \n");
+    QueryReply(time_str);
+    QueryReply(" \n");
+#endif
 }
 
 /**
@@ -224,16 +619,16 @@ bool SetDate(char* new_date_str)
     char month_str[10];
     char date_str[128];
 
-    int scan_res = sscanf(new_date_str, "%hhu-%3s-%hu", &date_temp.day, month_str, &date_temp.year);
+    int scan_res = sscanf(new_date_str, DATE_SCAN_FORMAT, &date_temp.day, month_str, &date_temp.year);
     date_temp.month = FindMonthValue(month_str)+1;
 
     if (scan_res == VALID_DATE_SCAN && systime_SetDate(&date_temp)) {
         retval = true;
-        sprintf(date_str, "%02u-%3s-%04u",
+        sprintf(date_str, DATE_PRINT_FORMAT,
                 date_temp.day, MONTHS[(date_temp.month-1)], date_temp.year);
 
-        UART0_puts(date_str);
-        UART0_puts(" \n");
+        QueryReply(date_str);
+        QueryReply(" \n");
     }
 
     return retval;
@@ -264,15 +659,24 @@ uint8_t FindMonthValue(char* month_str)
  */
 void DisplayDate()
 {
+#if SYSTIME_ASCII_CLOCK
+    char date_str[SYSTIME_DATE_STR_LEN + sizeof(" \n")];
+
+    systime_GetDateStr(date_str);
+    memcpy(date_str + SYSTIME_DATE_STR_LEN, " \n", sizeof(" \n"));
+
+    QueryReply(date_str);
+#else
     date_t date_temp;
     systime_GetDate(&date_temp);
 
     char date_str[128];
-    sprintf(date_str, "%02u-%3s-%04u",
+    sprintf(date_str, DATE_PRINT_FORMAT,
             date_temp.day, MONTHS[(date_temp.month-1)], date_temp.year);
 
-    UART0_puts(date_str);
-    UART0_puts(" \n");
+    QueryReply(date_str);
+    QueryReply(" \n");
+#endif
 }
 
 /**
@@ -288,7 +692,7 @@ bool SetAlarm(char* alarm_str)
     bool retval = false;
     char time_str[128];
 
-    int scan_res = sscanf(alarm_str, "%2hhu:%2hhu:%2hhu.%1hhu",
+    int scan_res = sscanf(alarm_str, TIME_SCAN_FORMAT,
                        &clock_temp.hour, &clock_temp.min,
                        &clock_temp.sec, &clock_temp.t_sec);
 
@@ -315,13 +719,13 @@ bool SetAlarm(char* alarm_str)
         }
         clock_temp.hour = clock_temp.hour % HOUR_IN_DAY;
 
-        sprintf(time_str, "%02u:%02u:%02u.%u",
+        sprintf(time_str, TIME_PRINT_FORMAT,
                 clock_temp.hour, clock_temp.min,
                 clock_temp.sec, clock_temp.t_sec);
 
-        UART0_puts("Alarm at ");
-        UART0_puts(time_str);
-        UART0_puts(" \n");
+        QueryReply("Alarm at ");
+        QueryReply(time_str);
+        QueryReply(" \n");
     }
 
     return retval;
@@ -330,9 +734,13 @@ bool SetAlarm(char* alarm_str)
 /**
  * @brief   Alarm Callback function.
  * @details Function is called when a set alarm's time has elapsed.
+ * @details It runs in the SysTick interrupt, so it's traced in the flight recorder
+ *          (with the TX buffer space it found) to tell a lockup in here apart from one elsewhere.
  */
 void Alarm_callback(void)
 {
+    FlightRec_Trace(FLIGHTREC_ALARM_IN, 0, UART0_TxFree());
+
     UART0_puts(ALARM_BELL);
     UART0_puts("\n* ALARM * ");
 
@@ -340,38 +748,45 @@ void Alarm_callback(void)
     systime_GetTime(&clock_temp);
 
     char time_str[128];
-    sprintf(time_str, "%02u:%02u:%02u.%u",
+    sprintf(time_str, TIME_PRINT_FORMAT,
             clock_temp.hour, clock_temp.min,
             clock_temp.sec, clock_temp.t_sec);
 
     UART0_puts(time_str);
     UART0_puts(" * \n");
     UART0_puts("> ");
+
+    FlightRec_Trace(FLIGHTREC_ALARM_OUT, 0, 0);
 }
 
 /**
- * @brief   Checks for a cursor escape code in the receive buffer
- *          and acts according to the cursor code found.
- * @param   [in, out]   rx_buf: Pointer to receive buffer with escape code
- *                              at the read pointer.
+ * @brief   Collects a cursor escape code a byte at a time
+ *          and acts according to the cursor code found once it's complete.
+ * @param   [in]    data: next byte of the escape code.
  * @details This function only checks for cursor codes that come from the arrow keys.
  *          Any other escape codes (including cursor code with multiple "moves") are not handled.
- * @details This function assumes that the escape char (x1b) has been previously detected and removed from the rx buffer.
+ * @details This function assumes that the escape char (x1b) has been previously detected (query.esc_len set to 1).
+ *          It never waits for the rest of the code, a lone escape just swallows the next two bytes.
  * @todo    Change this function so it handles more escape codes (or just handles them better)
  *          HINT: Escape code only contain one alphabetic character, and it's always at the end of the code.
  * @0todo:  create a query save buffer with the last couple of query entries and
             have the 'UP cursor' escape code select one of the save query entries.
  */
-void CursorCodeCheck(circular_buffer_t* rx_buf)
+void CursorCodeCheck(char data)
 {
-    escape_code_t esc_seq;
-    while (buffer_size(rx_buf) < sizeof(esc_seq)) ; // wait until the smallest escape command is in the buffer;
+    escape_code_t* esc_seq = &query.esc_seq;
 
-    dequeue(rx_buf, (uint8_t*)&esc_seq, sizeof(esc_seq));
+    if (query.esc_len == 1) {
+        esc_seq->sqbkrt = data;
+        query.esc_len++;
+        return;
+    }
+    esc_seq->code = data;
+    query.esc_len = 0;
 
-    switch (esc_seq.code) {
+    switch (esc_seq->code) {
         case 'A': {
-            UART0_puts(CURSOR_DOWN);
+            QueryReply(CURSOR_DOWN);
             /*
              * todo:
              * create a query save buffer with the last couple of query entries and
@@ -379,9 +794,9 @@ void CursorCodeCheck(circular_buffer_t* rx_buf)
              */
         } break;
         case 'B': {
-            UART0_puts(CURSOR_UP);
+            QueryReply(CURSOR_UP);
             while (query.buffer.wr_ptr < query.entry_ptr) {
-                UART0_puts(CURSOR_RIGHT);
+                QueryReply(CURSOR_RIGHT);
                 query.buffer.wr_ptr++;
             }
         } break;
@@ -390,7 +805,7 @@ void CursorCodeCheck(circular_buffer_t* rx_buf)
                 query.buffer.wr_ptr++;
             }
             else {
-                UART0_puts(CURSOR_LEFT);
+                QueryReply(CURSOR_LEFT);
             }
         } break;
         case 'D': {
@@ -398,8 +813,126 @@ void CursorCodeCheck(circular_buffer_t* rx_buf)
                 query.buffer.wr_ptr--;
             }
             else {
-                UART0_puts(CURSOR_RIGHT);
+                QueryReply(CURSOR_RIGHT);
             }
         } break;
     }
 }
+
+/**
+ * @brief   Displays the terminal session statistics.
+ * @details "queries,errors,throttled,yields,rx_dropped":
+ *          throttled counts lines held back by a rate limit,
+ *          yields counts updates that left input queued for the next main loop iteration.
+ */
+void DisplayStats(void)
+{
+    char row_str[64];   // five 10 digit counters
+
+    QueryReply("queries,errors,throttled,yields,rx_dropped\n");
+    sprintf(row_str, "%u,%u,%u,%u,%u\n",
+            session.queries, session.errors, session.throttled, session.yields, UART0_RxDropped());
+    QueryReply(row_str);
+}
+
+/**
+ * @brief   Sends a query reply to UART.
+ * @param   [in] str: null-terminated reply string.
+ * @details Replies (and echo fix-ups) are dropped while in bulk mode,
+ *          where the host only gets the batched acknowledgements.
+ */
+static void QueryReply(char* str)
+{
+    if (!bulk.en) {
+        UART0_puts(str);
+    }
+}
+
+/**
+ * @brief   Enters bulk (paste/upload) mode.
+ * @details Turns off the driver echo and the prompts so RX never competes with TX,
+ *          and resets the session's line and error counts.
+ */
+void BulkStart(void)
+{
+    UART0_puts("#BULK\n");
+
+    memset(&bulk, 0, sizeof(bulk));
+    bulk.echo_restore = UART0_SetEcho(UART0_ECHO_OFF);
+    bulk.en = true;
+}
+
+/**
+ * @brief   Leaves bulk mode.
+ * @details Acknowledges whatever is left of the current batch,
+ *          reports the session totals and restores the echo configuration.
+ */
+void BulkEnd(void)
+{
+    char summary_str[48];
+
+    BulkAck();
+
+    sprintf(summary_str, "#END %u ERR %u\n", bulk.lines, bulk.errors);
+    UART0_puts(summary_str);
+
+    UART0_SetEcho(bulk.echo_restore);
+    bulk.en = false;
+}
+
+/**
+ * @brief   Services a complete line received in bulk mode.
+ * @details Blank lines (i.e. the second half of a CR-LF pair) are ignored.
+ *          Failed lines are logged by line number for the next acknowledgement.
+ * @details Bulk lines aren't rate limited, so diagnostic queries aren't run and count as failed.
+ */
+static void BulkLine(void)
+{
+    if (query.entry_ptr == 0) return;
+
+    bulk.lines++;
+    bulk.batch_lines++;
+
+    if (QueryClassify() == QUERY_CLASS_DIAG || !QueryCheck()) {
+        if (bulk.batch_errors < BULK_ERR_LOG_SIZE) {
+            bulk.batch_err_lines[bulk.batch_errors] = bulk.lines;
+        }
+        bulk.batch_errors++;
+        bulk.errors++;
+    }
+
+    // the END line acknowledges on its own
+    if (bulk.en && bulk.batch_lines >= BULK_ACK_LINES) {
+        BulkAck();
+    }
+}
+
+/**
+ * @brief   Acknowledges the current bulk mode batch.
+ * @details Format: "#ACK <lines so far> OK <ok count> ERR <error count> [: <line> <line> ...]".
+ *          At most BULK_ERR_LOG_SIZE failed line numbers are listed per batch.
+ */
+static void BulkAck(void)
+{
+    char ack_str[64];
+    uint32_t i, logged;
+
+    if (bulk.batch_lines == 0) return;
+
+    sprintf(ack_str, "#ACK %u OK %u ERR %u",
+            bulk.lines, bulk.batch_lines - bulk.batch_errors, bulk.batch_errors);
+    UART0_puts(ack_str);
+
+    if (bulk.batch_errors) {
+        UART0_puts(" :");
+        logged = (bulk.batch_errors < BULK_ERR_LOG_SIZE) ? bulk.batch_errors : BULK_ERR_LOG_SIZE;
+        for (i = 0; i < logged; i++) {
+            sprintf(ack_str, " %u", bulk.batch_err_lines[i]);
+            UART0_puts(ack_str);
+        }
+    }
+    UART0_puts("\n");
+
+    bulk.batch_lines = 0;
+    bulk.batch_errors = 0;
+}
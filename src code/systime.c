@@ -5,7 +5,7 @@
  *          Contains all the functionality to maintain and keep track of time, date, and user-set alarms.
  * @author  Manuel Burnay
  * @date    2019.09.24 (Created)
- * @date    2019.10.03 (Last Modified)
+ * @date    2026.10.18 (Last Modified)
  *
  * @details Configures systick to activate every tenth of a second,
  *          and uses systick to maintain and upkeep an
@@ -19,11 +19,22 @@ static const uint8_t MONTH_DAYS[2][12] =  {
     {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}
 };  /// 2-D array that contains the valid day count for every month, for both leap years and non-leap years.
 
+/** Month abbreviations, January first */
+const char* const MONTHS[MONTH_IN_YEAR] = {
+    "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+    "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+};
+
 // Functions internal to the systime module
-void systime_IncDate_callback(void);
 inline uint8_t DaysInMonth(uint8_t month, uint16_t year);
 inline uint32_t systime_ConvertClock(clock_t* clock);
 inline clock_t systime_ConvertTickCounter(uint32_t t_count);
+void systime_Tick_callback(void);
+#if SYSTIME_ASCII_CLOCK
+static void systime_IncClock(void);
+static void systime_RenderClock(clock_t* clock);
+static void systime_RenderDate(void);
+#endif
 
 static systime_t time;  /// system time data structure.
 
@@ -49,6 +60,14 @@ void systime_init()
 	time.systick.countdown.value = 0;
 	time.systick.countdown.countdown_cb = NULL;
 
+	time.systick.tick_cb = systime_Tick_callback;
+	time.tick_hook_count = 0;
+
+#if SYSTIME_ASCII_CLOCK
+	systime_RenderClock(&(clock_t){0});
+	systime_RenderDate();
+#endif
+
 	SysTick_Init(&time.systick);
 }
 
@@ -64,12 +83,19 @@ void systime_init()
 bool systime_SetTime(clock_t* new_clock)
 {
     bool retval = false;
+    uint32_t primask;
+
     if (new_clock->t_sec < TSEC_IN_SEC  &&
         new_clock->sec < SEC_IN_MIN     &&
         new_clock->min < MIN_IN_HOUR    &&
         new_clock->hour < HOUR_IN_DAY) {
-            // todo: make this safer (via systick) to remove edge case corruption
+            // a tick between the two would advance the old clock string, leaving it out of step with the counter
+            primask = IRQ_SAVE();
             time.systick.counter.value = systime_ConvertClock(new_clock);
+#if SYSTIME_ASCII_CLOCK
+            systime_RenderClock(new_clock);
+#endif
+            IRQ_RESTORE(primask);
             retval = true;
         }
 
@@ -97,12 +123,17 @@ void systime_GetTime(clock_t* ret_clock)
 bool systime_SetDate(date_t* new_date)
 {
 	bool retval = false;
+	uint32_t primask;
 
 	if (new_date->year < 9999   &&
         new_date->month > 0     && new_date->month <= MONTH_IN_YEAR &&
         new_date->day > 0       && new_date->day <= DaysInMonth(new_date->month-1, new_date->year)) {
-	    // todo: Although the risk is small, look into doing this safely (via systick) to prevent edge case corruption
+        primask = IRQ_SAVE();   // the day rolls over from the tick, date and string are updated together
         time.date = *new_date;
+#if SYSTIME_ASCII_CLOCK
+        systime_RenderDate();
+#endif
+        IRQ_RESTORE(primask);
 
         retval = true;
     }
@@ -143,6 +174,32 @@ void systime_ClearAlarm()
     time.systick.countdown.en = false;
 }
 
+/**
+ * @brief   Gets the state of the alarm being tracked by the system.
+ * @param   [out] remaining: clock_t structure where the time left until the alarm is copied to
+ *          (only if the alarm is set).
+ * @return  [bool] True if an alarm is set, false if not.
+ */
+bool systime_GetAlarm(clock_t* remaining)
+{
+    bool retval;
+    uint32_t ticks, primask;
+
+    primask = IRQ_SAVE();
+    retval = time.systick.countdown.en;
+    ticks = time.systick.countdown.value;
+    IRQ_RESTORE(primask);
+
+    if (retval) {
+        remaining->t_sec = ticks % TSEC_IN_SEC;
+        remaining->sec = (ticks / TSEC_IN_SEC) % SEC_IN_MIN;
+        remaining->min = (ticks / TSEC_IN_MIN) % MIN_IN_HOUR;
+        remaining->hour = ticks / TSEC_IN_HOUR;
+    }
+
+    return retval;
+}
+
 /**
  * @brief   System time increment date callback function.
  * @details This function is sent to the systick driver to be called whenever the tick counter
@@ -163,6 +220,10 @@ void systime_IncDate_callback(void)
 		    time.date.year++;
 		}
 	}
+
+#if SYSTIME_ASCII_CLOCK
+	systime_RenderDate();
+#endif
 }
 
 /**
@@ -213,3 +274,153 @@ inline uint8_t DaysInMonth(uint8_t month, uint16_t year)
 {
     return MONTH_DAYS[IS_LEAP_YR(year)][month];
 }
+
+/**
+ * @brief   Registers a function to be called on every tick (tenth of a second).
+ * @param   [in] hook: function to be called. It runs in the SysTick interrupt, so keep it short.
+ * @return  [bool] True if the hook was registered, false if all SYSTIME_TICK_HOOKS slots are taken.
+ */
+bool systime_AddTickHook(void (*hook)(void))
+{
+    bool retval = false;
+
+    if (time.tick_hook_count < SYSTIME_TICK_HOOKS) {
+        time.tick_hooks[time.tick_hook_count] = hook;
+        time.tick_hook_count++;     // the slot is filled before the hook becomes visible to the tick
+        retval = true;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Trims the tick period, to make up for the clock source's error.
+ * @param   [in] ppm: period adjustment, in parts per million. Positive values lengthen the period (slow the clock down).
+ * @details Takes effect on the next SysTick reload, the count in progress isn't touched.
+ */
+void systime_SetTrim(int32_t ppm)
+{
+    uint32_t period = F_CPU_CLK / time.systick.tick_rate;
+
+    SysTick_SetPeriod(period + (int32_t)(((int64_t)period * ppm) / 1000000));
+}
+
+/**
+ * @brief   System time tick callback function.
+ * @details Called by the systick driver on every tick (tenth of a second).
+ *          Advances the ASCII clock (if enabled) and calls the registered tick hooks.
+ */
+void systime_Tick_callback(void)
+{
+    uint8_t i;
+
+#if SYSTIME_ASCII_CLOCK
+    systime_IncClock();
+#endif
+
+    for (i = 0; i < time.tick_hook_count; i++) {
+        time.tick_hooks[i]();
+    }
+}
+
+#if SYSTIME_ASCII_CLOCK
+/**
+ * @brief   Increments the ASCII clock by a tenth of a second.
+ * @details Increments the clock one digit at a time and only carries into
+ *          the next digit when one overflows, so most ticks only touch the tenths digit.
+ * @details The clock wraps from 23:59:59.9 to 00:00:00.0 on the same tick
+ *          the tick counter resets and the date gets incremented.
+ */
+static void systime_IncClock(void)
+{
+    char* s = time.clock_str;   // "hh:mm:ss.t"
+
+    if (++s[9] <= '9') return;  // tenths
+    s[9] = '0';
+    if (++s[7] <= '9') return;  // seconds
+    s[7] = '0';
+    if (++s[6] <= '5') return;  // tens of seconds
+    s[6] = '0';
+    if (++s[4] <= '9') return;  // minutes
+    s[4] = '0';
+    if (++s[3] <= '5') return;  // tens of minutes
+    s[3] = '0';
+
+    if (s[0] == '2' && s[1] == '3') {   // hours (00..23)
+        s[0] = '0';
+        s[1] = '0';
+    }
+    else if (++s[1] > '9') {
+        s[1] = '0';
+        s[0]++;
+    }
+}
+
+/**
+ * @brief   Gets the current system time as a "hh:mm:ss.t" string.
+ * @param   [out] ret_str: Where the string is copied to.
+ *          Must fit SYSTIME_CLOCK_STR_LEN+1 characters (it's null-terminated).
+ */
+void systime_GetTimeStr(char* ret_str)
+{
+    uint32_t primask = IRQ_SAVE();    // callers may already have interrupts masked (the benchmark does)
+    memcpy(ret_str, time.clock_str, SYSTIME_CLOCK_STR_LEN);
+    IRQ_RESTORE(primask);
+
+    ret_str[SYSTIME_CLOCK_STR_LEN] = '\0';
+}
+
+/**
+ * @brief   Gets the current system date as a "dd-MMM-yyyy" string.
+ * @param   [out] ret_str: Where the string is copied to.
+ *          Must fit SYSTIME_DATE_STR_LEN+1 characters (it's null-terminated).
+ */
+void systime_GetDateStr(char* ret_str)
+{
+    uint32_t primask = IRQ_SAVE();
+    memcpy(ret_str, time.date_str, SYSTIME_DATE_STR_LEN);
+    IRQ_RESTORE(primask);
+
+    ret_str[SYSTIME_DATE_STR_LEN] = '\0';
+}
+
+/**
+ * @brief   Re-renders the ASCII clock from a clock structure.
+ * @param   [in] clock: clock to be rendered. Values are assumed to be valid.
+ */
+static void systime_RenderClock(clock_t* clock)
+{
+    char* s = time.clock_str;
+
+    s[0] = '0' + clock->hour/10;
+    s[1] = '0' + clock->hour%10;
+    s[2] = ':';
+    s[3] = '0' + clock->min/10;
+    s[4] = '0' + clock->min%10;
+    s[5] = ':';
+    s[6] = '0' + clock->sec/10;
+    s[7] = '0' + clock->sec%10;
+    s[8] = '.';
+    s[9] = '0' + clock->t_sec;
+}
+
+/**
+ * @brief   Re-renders the ASCII date from the system date.
+ * @details Only called when the date changes (set by the user or daily rollover).
+ */
+static void systime_RenderDate(void)
+{
+    char* s = time.date_str;
+    uint16_t year = time.date.year;
+
+    s[0] = '0' + time.date.day/10;
+    s[1] = '0' + time.date.day%10;
+    s[2] = '-';
+    memcpy(s+3, MONTHS[time.date.month-1], 3);
+    s[6] = '-';
+    s[10] = '0' + year%10; year /= 10;
+    s[9] = '0' + year%10;  year /= 10;
+    s[8] = '0' + year%10;  year /= 10;
+    s[7] = '0' + year%10;
+}
+#endif
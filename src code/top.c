@@ -0,0 +1,278 @@
+
+/**
+ * @file    top.c
+ * @brief   Full-screen live view of interrupts, CPU load, buffers, queries and the alarm.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details The view takes over the terminal until any key is pressed.
+ *          Every refresh renders the whole view into row strings, but only the cells that differ
+ *          from what the terminal already shows are sent (each changed run after a cursor move),
+ *          so a steady view costs a few bytes per refresh instead of a full screen.
+ * @details CPU load is the share of cycles spent in interrupt handlers,
+ *          the main loop never sleeps, so its pass rate is shown instead of an idle time.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include "top.h"
+#include "systime.h"
+#include "query_handler.h"
+#include "irqmon.h"
+
+#define TOP_CYC_PER_MS  (F_CPU_CLK/1000)
+#define TOP_CYC_PER_US  (F_CPU_CLK/1000000)
+
+static top_t top;
+
+static void Top_Start(uint16_t period);
+static void Top_Refresh(uart_descriptor_t* uart);
+static void Top_Row(uint8_t row, const char* format, ...);
+static void Top_Draw(uint8_t row, char* line);
+
+/**
+ * @brief   Initializes the top view.
+ * @details Make sure systime has been initialized prior to calling this function,
+ *          the refreshes are paced by a systime tick hook.
+ */
+void Top_Init(void)
+{
+    top.en = false;
+    systime_AddTickHook(Top_Tick);
+}
+
+/**
+ * @brief   Services the top query.
+ * @param   [in] args: query set data, NULL or the refresh period in tenths of a second.
+ * @return  [bool] True if the arguments were valid (and the view started).
+ */
+bool Top_Query(char* args)
+{
+    unsigned int period = TOP_PERIOD_DEFAULT;
+    char trailing;
+    bool retval = true;
+
+    if (args != NULL) {
+        retval = (sscanf(args, "%u%c", &period, &trailing) == 1 && period > 0 && period <= TOP_PERIOD_MAX);
+    }
+
+    if (retval) {
+        Top_Start(period);
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Takes over the terminal.
+ * @param   [in] period: refresh period, in systime ticks.
+ * @details Echo is turned off so the key that ends the view doesn't land on it.
+ *          The screen mirror is zeroed, which no rendered cell matches, so the first refresh paints everything.
+ */
+static void Top_Start(uint16_t period)
+{
+    memset(top.screen, 0, sizeof(top.screen));
+    isr_stats_sample(top.last_isr);
+    top.last_stamp = CYCCNT();
+    top.loops = 0;
+
+    top.echo_restore = UART0_SetEcho(UART0_ECHO_OFF);
+    UART0_puts(CURSOR_HIDE);
+    UART0_puts(CLEAR_SCREEN);
+
+    DISABLE_IRQ();
+    top.period = period;
+    top.ticks = 0;
+    top.refresh = false;
+    top.en = true;
+    ENABLE_IRQ();
+}
+
+/**
+ * @brief   Gives the terminal back to the query handler.
+ */
+void Top_Stop(void)
+{
+    top.en = false;
+
+    UART0_puts(CLEAR_SCREEN);
+    UART0_puts(CURSOR_HOME);
+    UART0_puts(CURSOR_SHOW);
+    UART0_SetEcho(top.echo_restore);
+    UART0_puts("> ");
+}
+
+/**
+ * @brief   Determines if the top view currently owns the console.
+ */
+bool Top_Running(void)
+{
+    return top.en;
+}
+
+/**
+ * @brief   Top view update function, called from the main loop while the view is up.
+ * @param   [in, out] uart: console UART descriptor.
+ * @details Refreshes the view when the refresh period has elapsed,
+ *          and closes it if anything was typed on the console.
+ */
+void Top_Update(uart_descriptor_t* uart)
+{
+    top.loops++;
+
+    if (buffer_size(&uart->rx) != BUFFER_EMPTY) {
+        dequeue(&uart->rx, NULL, buffer_size(&uart->rx));
+        Top_Stop();
+    }
+    else if (top.refresh) {
+        top.refresh = false;
+        Top_Refresh(uart);
+    }
+}
+
+/**
+ * @brief   Top view tick function.
+ * @details Registered as a systime tick hook, flags a refresh every period ticks.
+ */
+void Top_Tick(void)
+{
+    if (top.en && ++top.ticks >= top.period) {
+        top.ticks = 0;
+        top.refresh = true;
+    }
+}
+
+/**
+ * @brief   Renders the view and sends what changed.
+ * @param   [in] uart: console UART descriptor (for the ring occupancies).
+ */
+static void Top_Refresh(uart_descriptor_t* uart)
+{
+    isr_stat_t sample[ISR_COUNT];
+    uint32_t now, elapsed_ms, calls, cycles, isr_cycles = 0;
+    uint32_t us_x10, load_x10;
+    circular_buffer_t* log = IrqMon_Log();
+    clock_t clock_temp;
+    date_t date_temp;
+    uint8_t i;
+
+    isr_stats_sample(sample);
+    now = CYCCNT();
+    elapsed_ms = (now - top.last_stamp) / TOP_CYC_PER_MS;
+    if (elapsed_ms == 0) elapsed_ms = 1;
+
+    systime_GetTime(&clock_temp);
+    systime_GetDate(&date_temp);
+
+    Top_Row(0, "top  " TIME_PRINT_FORMAT "  " DATE_PRINT_FORMAT "   every %u.%us",
+            clock_temp.hour, clock_temp.min, clock_temp.sec, clock_temp.t_sec,
+            date_temp.day, MONTHS[date_temp.month-1], date_temp.year,
+            top.period / TSEC_IN_SEC, top.period % TSEC_IN_SEC);
+
+    Top_Row(3, "isr        calls/s    us/call   load %%");
+    for (i = 0; i < ISR_COUNT; i++) {
+        calls = sample[i].count - top.last_isr[i].count;
+        cycles = sample[i].cycles - top.last_isr[i].cycles;
+        isr_cycles += cycles;
+
+        us_x10 = calls ? (cycles * 10) / (calls * TOP_CYC_PER_US) : 0;
+        load_x10 = cycles / elapsed_ms / (TOP_CYC_PER_MS / 1000);
+
+        Top_Row(4 + i, "%-8s %10u %8u.%u %6u.%u", ISR_NAMES[i], (calls * 1000) / elapsed_ms,
+                us_x10 / 10, us_x10 % 10, load_x10 / 10, load_x10 % 10);
+    }
+
+    load_x10 = isr_cycles / elapsed_ms / (TOP_CYC_PER_MS / 1000);
+    Top_Row(1, "irq load %3u.%u%%   loop %8u/s   rx drop %u",
+            load_x10 / 10, load_x10 % 10, (top.loops * 1000) / elapsed_ms, uart->rx_dropped);
+
+    Top_Row(10, "ring         used   hwm  size");
+    Top_Row(11, "uart0 rx   %6u %5u %5u", buffer_size(&uart->rx), uart->rx.hwm, CIRCULAR_BUFFER_MASK);
+    Top_Row(12, "uart0 tx   %6u %5u %5u", buffer_size(&uart->tx), uart->tx.hwm, CIRCULAR_BUFFER_MASK);
+    Top_Row(13, "irqmon log %6u %5u %5u", buffer_size(log), log->hwm, CIRCULAR_BUFFER_MASK);
+
+    if (systime_GetAlarm(&clock_temp)) {
+        Top_Row(15, "alarm      in " TIME_PRINT_FORMAT,
+                clock_temp.hour, clock_temp.min, clock_temp.sec, clock_temp.t_sec);
+    }
+    else {
+        Top_Row(15, "alarm      off");
+    }
+
+    Top_Row(17, "last queries");
+    for (i = 0; i < QUERY_HISTORY; i++) {
+        Top_Row(18 + i, "%s", QueryHistory(i));
+    }
+
+    // rows left blank still need painting on the first refresh
+    Top_Row(2, "");
+    Top_Row(9, "");
+    Top_Row(14, "");
+    Top_Row(16, "");
+
+    memcpy(top.last_isr, sample, sizeof(sample));
+    top.last_stamp = now;
+    top.loops = 0;
+}
+
+/**
+ * @brief   Renders a row of the view and sends the cells that changed.
+ * @param   [in] row: row number (0..TOP_ROWS-1).
+ * @param   [in] format: printf format of the row, anything past TOP_COLS is cut off.
+ */
+static void Top_Row(uint8_t row, const char* format, ...)
+{
+    char line[TOP_COLS + 1];
+    uint32_t length;
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    length = strlen(line);
+    memset(line + length, ' ', TOP_COLS - length);     // pad, so shorter values clear the old ones
+
+    Top_Draw(row, line);
+}
+
+/**
+ * @brief   Sends the cells of a row that differ from the terminal, and updates the screen mirror.
+ * @param   [in] row: row number (0..TOP_ROWS-1).
+ * @param   [in] line: rendered row, TOP_COLS characters.
+ * @details Changed cells less than TOP_MERGE_GAP cells apart are sent as a single run.
+ */
+static void Top_Draw(uint8_t row, char* line)
+{
+    char* shown = top.screen[row];
+    char move_str[16];
+    uint8_t col = 0, start, end, same;
+
+    while (col < TOP_COLS) {
+        if (line[col] == shown[col]) {
+            col++;
+            continue;
+        }
+
+        start = col;
+        end = col + 1;
+        for (col = end, same = 0; col < TOP_COLS && same < TOP_MERGE_GAP; col++) {
+            if (line[col] != shown[col]) {
+                end = col + 1;
+                same = 0;
+            }
+            else {
+                same++;
+            }
+        }
+
+        sprintf(move_str, CURSOR_POSITION_FORMAT, row + 1, start + 1);
+        UART0_puts(move_str);
+        UART0_write(line + start, end - start);
+        memcpy(shown + start, line + start, end - start);
+
+        col = end;
+    }
+}
@@ -0,0 +1,289 @@
+
+/**
+ * @file    tunables.c
+ * @brief   Runtime tunables registry: performance settings that can be read, changed and saved without a rebuild.
+ * @author  Manuel Burnay
+ * @date    2026.10.18 (Created)
+ * @date    2026.10.18 (Last Modified)
+ *
+ * @details Each tunable has a name, a range and a default (the compile-time constant it replaces),
+ *          and either an apply hook that pushes new values to its owner, or an owner that reads it when it's used.
+ *          Values are checked against their range before they're applied, so the hooks only ever see valid values.
+ * @details Tunables are saved to the EEPROM on request ("set save"), as one record with a magic and a CRC,
+ *          and loaded back on boot. A record with the wrong magic or CRC (never saved, or saved by a build
+ *          with other tunables) is ignored, and so is any saved value that's out of its range now.
+ * @details Sizes that arrays are built with (CIRCULAR_BUFFER_SIZE and the like) can't change at runtime,
+ *          they bound the ranges of the thresholds that work within them instead.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include "tunables.h"
+#include "uart.h"
+#include "systime.h"
+#include "query_handler.h"
+#include "bridge.h"
+#include "baud.h"
+#include "flightrec.h"
+#include "eeprom.h"
+#include "crc32.h"
+
+#define TUNABLES_RECORD_WORDS   (sizeof(tunables_record_t)/sizeof(uint32_t))
+#define TUNABLES_CRC_LENGTH     (offsetof(tunables_record_t, crc))
+#define TUNABLES_NAME_LEN       24
+
+static void Tunables_ApplyTrim(int32_t value);
+static void Tunables_ApplyFifoLevels(int32_t value);
+static void Tunables_ApplyEcho(int32_t value);
+static void Tunables_ApplyRateLimit(int32_t value);
+static void Tunables_ApplyWdtTimeout(int32_t value);
+
+/**
+ * @brief   Tunables registry, in TUNABLE_IDS order.
+ */
+static const tunable_t TUNABLES[TUNE_COUNT] = {
+    {"TICK_TRIM",               -20000, 20000,                  0,                      Tunables_ApplyTrim},
+    {"UART0_RX_LEVEL",          0,      UART_IFLS_LEVEL_MAX,    2,                      Tunables_ApplyFifoLevels},
+    {"UART0_TX_LEVEL",          0,      UART_IFLS_LEVEL_MAX,    2,                      Tunables_ApplyFifoLevels},
+    {"ECHO",                    0,      1,                      UART0_ECHO_ON,          Tunables_ApplyEcho},
+    {"QUERY_BUDGET",            1,      CIRCULAR_BUFFER_MASK,   QUERY_BUDGET_CHARS,     NULL},
+    {"QUERY_BURST",             1,      1000,                   SESSION_RATE_BURST,     Tunables_ApplyRateLimit},
+    {"QUERY_PERIOD",            1,      100,                    SESSION_RATE_PERIOD,    Tunables_ApplyRateLimit},
+    {"SNIFF_LZ_CHUNK",          1,      CIRCULAR_BUFFER_MASK,   BRIDGE_LZ_CHUNK,        NULL},
+    {"BAUD_ERR_LIMIT",          1,      1000,                   BAUD_ERR_LIMIT,         NULL},
+    {"BAUD_BAD_WINDOWS",        1,      60,                     BAUD_BAD_WINDOWS,       NULL},
+    {"BAUD_QUIET_WINDOWS",      1,      3600,                   BAUD_QUIET_WINDOWS,     NULL},
+    {"BAUD_CONFIRM_WINDOWS",    2,      60,                     BAUD_CONFIRM_WINDOWS,   NULL},
+    {"WDT_TIMEOUT",             3,      60,                     FLIGHTREC_WDT_TIMEOUT,  Tunables_ApplyWdtTimeout},
+};
+
+static int32_t values[TUNE_COUNT];
+static bool eeprom_ok;
+
+static int8_t Tunables_Find(char* name);
+static bool Tunables_Save(void);
+static void Tunables_Defaults(void);
+static void Tunables_Report(uint8_t id);
+
+/**
+ * @brief   Loads the saved tunables (the defaults for any that weren't saved), and applies them all.
+ * @details Make sure the UART driver, systime and the flight recorder have been initialized prior to calling this function,
+ *          and call it before anything that reads tunables (Tunables_Get returns 0 until then).
+ */
+void Tunables_Init(void)
+{
+    tunables_record_t record;
+    bool loaded = false;
+    uint8_t id;
+
+    eeprom_ok = EEPROM_Init();
+
+    if (eeprom_ok && EEPROM_Read(TUNABLES_EEPROM_ADDR, (uint32_t*)&record, TUNABLES_RECORD_WORDS)) {
+        loaded = (record.magic == (TUNABLES_MAGIC | TUNE_COUNT)) &&
+                 (crc32(&record, TUNABLES_CRC_LENGTH) == record.crc);
+    }
+
+    // every value is in place before any hook runs, some hooks apply two tunables at once
+    for (id = 0; id < TUNE_COUNT; id++) {
+        values[id] = TUNABLES[id].def;
+        if (loaded && record.values[id] >= TUNABLES[id].min && record.values[id] <= TUNABLES[id].max) {
+            values[id] = record.values[id];
+        }
+    }
+
+    for (id = 0; id < TUNE_COUNT; id++) {
+        if (TUNABLES[id].apply != NULL) TUNABLES[id].apply(values[id]);
+    }
+}
+
+/**
+ * @brief   Gets the current value of a tunable.
+ * @param   [in] id: tunable (see TUNABLE_IDS).
+ * @details Values are single words, so this is safe from interrupt handlers too.
+ */
+int32_t Tunables_Get(uint8_t id)
+{
+    return values[id];
+}
+
+/**
+ * @brief   Changes a tunable, and applies the new value.
+ * @param   [in] id: tunable (see TUNABLE_IDS).
+ * @param   [in] value: new value.
+ * @return  [bool] True if the value was in range (and applied).
+ */
+bool Tunables_Set(uint8_t id, int32_t value)
+{
+    if (id >= TUNE_COUNT || value < TUNABLES[id].min || value > TUNABLES[id].max) return false;
+
+    values[id] = value;
+    if (TUNABLES[id].apply != NULL) TUNABLES[id].apply(value);
+
+    return true;
+}
+
+/**
+ * @brief   Services the get query: reports a tunable.
+ * @param   [in] args: tunable name.
+ * @return  [bool] True if there is such a tunable.
+ */
+bool Tunables_GetQuery(char* args)
+{
+    int8_t id;
+
+    if (args == NULL || (id = Tunables_Find(args)) < 0) return false;
+
+    UART0_puts("name,value,min,max,default\n");
+    Tunables_Report(id);
+
+    return true;
+}
+
+/**
+ * @brief   Services the set query.
+ * @param   [in] args: query set data. Supported forms:
+ *          - <name> <value>:   change a tunable (applied right away, not saved),
+ *          - SAVE:             save the current values to the EEPROM, they're loaded on every boot from then on,
+ *          - DEFAULTS:         go back to the defaults (not saved, "set save" afterwards to make it stick).
+ * @return  [bool] True if the arguments were valid (and the save worked).
+ */
+bool Tunables_SetQuery(char* args)
+{
+    char name[TUNABLES_NAME_LEN], trailing;
+    long value;
+    int8_t id;
+
+    if (args == NULL) return false;
+
+    if (strcmp(args, "SAVE") == 0) {
+        return Tunables_Save();
+    }
+    if (strcmp(args, "DEFAULTS") == 0) {
+        Tunables_Defaults();
+        return true;
+    }
+    if (sscanf(args, "%23s %ld%c", name, &value, &trailing) != 2 || (id = Tunables_Find(name)) < 0) {
+        return false;
+    }
+
+    return Tunables_Set(id, value);
+}
+
+/**
+ * @brief   Services the list query: reports every tunable.
+ */
+bool Tunables_ListQuery(char* args)
+{
+    uint8_t id;
+
+    if (args != NULL) return false;
+
+    UART0_puts("name,value,min,max,default\n");
+    for (id = 0; id < TUNE_COUNT; id++) {
+        Tunables_Report(id);
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Finds a tunable by its name.
+ * @return  [int8_t] Tunable id, -1 if there's no such tunable.
+ */
+static int8_t Tunables_Find(char* name)
+{
+    int8_t id;
+
+    for (id = 0; id < TUNE_COUNT; id++) {
+        if (strcmp(name, TUNABLES[id].name) == 0) return id;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief   Saves the current values to the EEPROM.
+ * @return  [bool] True if they were saved.
+ */
+static bool Tunables_Save(void)
+{
+    tunables_record_t record;
+
+    if (!eeprom_ok) return false;
+
+    record.magic = TUNABLES_MAGIC | TUNE_COUNT;
+    memcpy(record.values, values, sizeof(record.values));
+    record.crc = crc32(&record, TUNABLES_CRC_LENGTH);
+
+    return EEPROM_Write(TUNABLES_EEPROM_ADDR, (const uint32_t*)&record, TUNABLES_RECORD_WORDS);
+}
+
+/**
+ * @brief   Sets every tunable back to its default, and applies them.
+ */
+static void Tunables_Defaults(void)
+{
+    uint8_t id;
+
+    for (id = 0; id < TUNE_COUNT; id++) {
+        values[id] = TUNABLES[id].def;
+    }
+    for (id = 0; id < TUNE_COUNT; id++) {
+        if (TUNABLES[id].apply != NULL) TUNABLES[id].apply(values[id]);
+    }
+}
+
+/**
+ * @brief   Sends a tunable's CSV row (name,value,min,max,default).
+ */
+static void Tunables_Report(uint8_t id)
+{
+    char report_str[80];
+
+    sprintf(report_str, "%s,%ld,%ld,%ld,%ld\n", TUNABLES[id].name, (long)values[id],
+            (long)TUNABLES[id].min, (long)TUNABLES[id].max, (long)TUNABLES[id].def);
+    UART0_puts(report_str);
+}
+
+/**
+ * @brief   TICK_TRIM hook: the SysTick reload is picked up on its next wrap.
+ */
+static void Tunables_ApplyTrim(int32_t value)
+{
+    systime_SetTrim(value);
+}
+
+/**
+ * @brief   UART0_RX_LEVEL/UART0_TX_LEVEL hook: both levels share a register, which is written in one go.
+ */
+static void Tunables_ApplyFifoLevels(int32_t value)
+{
+    (void)value;
+    UART0_SetFifoLevels(values[TUNE_UART0_RX_LEVEL], values[TUNE_UART0_TX_LEVEL]);
+}
+
+/**
+ * @brief   ECHO hook: the UART interrupt handler checks the flag for every byte.
+ */
+static void Tunables_ApplyEcho(int32_t value)
+{
+    UART0_SetEcho(value);
+}
+
+/**
+ * @brief   QUERY_BURST/QUERY_PERIOD hook: the session's bucket is swapped with interrupts masked.
+ */
+static void Tunables_ApplyRateLimit(int32_t value)
+{
+    (void)value;
+    QueryHandler_SetRateLimit(values[TUNE_QUERY_BURST], values[TUNE_QUERY_PERIOD]);
+}
+
+/**
+ * @brief   WDT_TIMEOUT hook: the watchdog count starts over with the new load.
+ */
+static void Tunables_ApplyWdtTimeout(int32_t value)
+{
+    FlightRec_SetTimeout(value);
+}
@@ -3,13 +3,15 @@
  * @brief  C file all function definitions regarding circular buffer operation.
  * @author Manuel Burnay
  * @date   2019.09.17 (Created)
- * @date   2019.10.03 (Last Modified)
+ * @date   2026.10.18 (Last Modified)
  */
 
 
 #include <string.h>
 #include "circular_buffer.h"
 
+static inline void buffer_track_hwm(circular_buffer_t* buffer);
+
 /**
  * @brief  Initializes a circular buffer structure.
  * @param  [out] buffer: pointer to circular buffer structure being initialized
@@ -18,6 +20,18 @@ void circular_buffer_init(circular_buffer_t* buffer)
 {
 	buffer->wr_ptr = 0;
 	buffer->rd_ptr = 0;
+	buffer->hwm = 0;
+}
+
+/**
+ * @brief   Updates the buffer's high-water mark with its current occupancy.
+ * @param   [in, out] buffer: pointer to circular buffer being used.
+ */
+static inline void buffer_track_hwm(circular_buffer_t* buffer)
+{
+    uint32_t size = buffer_size(buffer);
+
+    if (size > buffer->hwm) buffer->hwm = size;
 }
 
 /**
@@ -52,6 +66,7 @@ bool enqueuec_s(circular_buffer_t* buffer, char c, bool OVERWRITE)
     if (temp_wr != buffer->rd_ptr) {
         buffer->data[buffer->wr_ptr] = c;
         INC_PTR(buffer->wr_ptr);
+        buffer_track_hwm(buffer);
         retval = true;
     }
     else if (OVERWRITE) {
@@ -91,7 +106,8 @@ inline uint32_t enqueues(circular_buffer_t* buffer, char* s)
  */
 uint32_t enqueue(circular_buffer_t* buffer, char* src_buf, uint32_t length)
 {
-    uint32_t space = CIRCULAR_BUFFER_SIZE - buffer_size(buffer);
+    // One slot always stays free so a full buffer can't be mistaken for an empty one
+    uint32_t space = CIRCULAR_BUFFER_MASK - buffer_size(buffer);
 
     // truncate length if it's over the free space in the buffer
     if (length > space) {
@@ -109,6 +125,7 @@ uint32_t enqueue(circular_buffer_t* buffer, char* src_buf, uint32_t length)
         }
 
         MOV_PTR(buffer->wr_ptr, length);
+        buffer_track_hwm(buffer);
     }
     else {
         length = 0;
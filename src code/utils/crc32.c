@@ -0,0 +1,50 @@
+/**
+ * @file   crc32.c
+ * @brief  C file all function definitions regarding CRC-32 checksums.
+ * @author Manuel Burnay
+ * @date   2026.10.18 (Created)
+ * @date   2026.10.18 (Last Modified)
+ *
+ * @details Standard (zlib/ethernet) CRC-32, reflected polynomial 0xEDB88320.
+ *          The table is indexed by nibble, so it only takes 64 bytes of flash
+ *          for two lookups per byte.
+ */
+
+
+#include "crc32.h"
+
+static const uint32_t CRC32_NIBBLE[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/**
+ * @brief   Adds a block of data to a running CRC.
+ * @param   [in] crc: running CRC (CRC32_INIT for the first block).
+ * @param   [in] data: block of data.
+ * @param   [in] length: block length, in bytes.
+ * @return  [uint32_t] Updated running CRC (not finalized, see crc32()).
+ */
+uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length)
+{
+    const uint8_t* p = data;
+
+    while (length--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ CRC32_NIBBLE[crc & 0x0F];
+        crc = (crc >> 4) ^ CRC32_NIBBLE[crc & 0x0F];
+    }
+
+    return crc;
+}
+
+/**
+ * @brief   Computes the CRC-32 of a block of data.
+ * @param   [in] data: block of data.
+ * @param   [in] length: block length, in bytes.
+ * @return  [uint32_t] CRC-32 (crc32("123456789") is 0xCBF43926).
+ */
+uint32_t crc32(const void* data, uint32_t length)
+{
+    return crc32_update(CRC32_INIT, data, length) ^ 0xFFFFFFFF;
+}
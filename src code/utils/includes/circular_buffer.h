@@ -4,7 +4,7 @@
  *			used to operate a circular buffer.
  * @author Manuel Burnay
  * @date	2019.09.17 (Created)
- * @date	2019.10.03 (Last Modified)
+ * @date	2026.10.18 (Last Modified)
  */
 
 #ifndef CIRCULAR_BUFFER_H
@@ -46,11 +46,13 @@
 	/**
 	 * @brief	circular buffer structure.
 	 * @details The size of the buffer is determined by the CIRCULAR_BUFFER_SIZE
+	 * @details hwm is the highest occupancy seen by the safe enqueue functions since init.
 	 */
 	typedef struct circular_buffer_{
 		char data[CIRCULAR_BUFFER_SIZE];
 		uint32_t rd_ptr;
 		uint32_t wr_ptr;
+		uint32_t hwm;
 	} circular_buffer_t;
 
 
@@ -3,17 +3,90 @@
  *	@brief	Has some general functionality/information about the C-M4 cpu.
  *	@author	Manuel Burnay
  *	@date 	2019.09.24	(Created)
- *	@date	2019.09.30	(Last Modified)
+ *	@date	2026.10.18	(Last Modified)
  */
 
 #ifndef CPU_H
 	#define CPU_H
 
 
+	#include <stdint.h>
+
 	#define ENABLE_IRQ() __asm(" cpsie i")
 	#define DISABLE_IRQ() __asm(" cpsid i")
 
+	/**
+	 * @brief   Masks interrupts, returning the previous mask (PRIMASK) for IRQ_RESTORE.
+	 * @details Use this pair instead of DISABLE_IRQ/ENABLE_IRQ in code that can run
+	 *          from an interrupt handler or inside another critical section,
+	 *          ENABLE_IRQ would unmask interrupts there.
+	 */
+	#if defined(__TI_COMPILER_VERSION__)
+		#define IRQ_SAVE()			_disable_interrupts()
+		#define IRQ_RESTORE(key)	_restore_interrupts(key)
+	#else
+		#define IRQ_SAVE()			cpu_irq_save()
+		#define IRQ_RESTORE(key)	cpu_irq_restore(key)
+
+		static inline uint32_t cpu_irq_save(void)
+		{
+			uint32_t primask;
+			__asm volatile (" mrs %0, primask\n cpsid i" : "=r" (primask) : : "memory");
+			return primask;
+		}
+
+		static inline void cpu_irq_restore(uint32_t primask)
+		{
+			__asm volatile (" msr primask, %0" : : "r" (primask) : "memory");
+		}
+	#endif
+
 
 	#define F_CPU_CLK	16000000
 
+	// Debug Watchpoint and Trace (DWT) cycle counter
+	#define CPU_DEMCR_R		(*((volatile unsigned long *)0xE000EDFC))	/// Debug Exception and Monitor Control Register
+	#define CPU_DWT_CTRL_R		(*((volatile unsigned long *)0xE0001000))	/// DWT Control Register
+	#define CPU_DWT_CYCCNT_R	(*((volatile unsigned long *)0xE0001004))	/// DWT Cycle Count Register
+
+	#define CPU_DEMCR_TRCENA		0x01000000	// Enable the DWT & ITM units
+	#define CPU_DWT_CTRL_CYCCNTENA	0x00000001	// Enable the cycle counter
+
+	/**
+	 * @brief   Starts the free-running DWT cycle counter (wraps every 2^32 cycles).
+	 */
+	#define CYCCNT_ENABLE() do {						\
+		CPU_DEMCR_R |= CPU_DEMCR_TRCENA;			\
+		CPU_DWT_CTRL_R |= CPU_DWT_CTRL_CYCCNTENA;	\
+	} while (0)
+
+	#define CYCCNT()	(CPU_DWT_CYCCNT_R)
+
+	// System Control Block
+	#define CPU_APINT_R		(*((volatile unsigned long *)0xE000ED0C))	/// Application Interrupt and Reset Control Register
+	#define CPU_SHCSR_R		(*((volatile unsigned long *)0xE000ED24))	/// System Handler Control and State Register
+	#define CPU_NVIC_ACTIVE0_R	(*((volatile unsigned long *)0xE000E300))	/// Interrupt 0-31 Active Bit Register
+	#define CPU_NVIC_ACTIVE1_R	(*((volatile unsigned long *)0xE000E304))	/// Interrupt 32-63 Active Bit Register
+
+	#define CPU_APINT_VECTKEY		0x05FA0000	// Key required to write APINT
+	#define CPU_APINT_SYSRESREQ		0x00000004	// System reset request
+
+	/**
+	 * @brief   Requests a system reset (RAM contents are kept).
+	 */
+	#define CPU_RESET() do {								\
+		CPU_APINT_R = CPU_APINT_VECTKEY | CPU_APINT_SYSRESREQ;	\
+		while (1) ;										\
+	} while (0)
+
+	/**
+	 * @brief   Places a variable in RAM that the C startup code leaves alone, so it survives resets.
+	 * @details With GCC the linker script needs a NOLOAD ".noinit" output section in SRAM.
+	 */
+	#if defined(__TI_COMPILER_VERSION__)
+		#define CPU_NOINIT	__attribute__((noinit))
+	#else
+		#define CPU_NOINIT	__attribute__((section(".noinit")))
+	#endif
+
 #endif // CPU_H
@@ -0,0 +1,20 @@
+/**
+ * @file	crc32.h
+ * @brief	Header file with the function prototypes used to compute CRC-32 checksums.
+ * @author	Manuel Burnay
+ * @date	2026.10.18 (Created)
+ * @date	2026.10.18 (Last Modified)
+ */
+
+#ifndef CRC32_H
+	#define CRC32_H
+
+    #include <stdint.h>
+
+	#define CRC32_INIT	0xFFFFFFFF	/// Starting value of a CRC, pass it as crc to the first crc32_update call
+
+	// CRC-32 function prototypes
+	uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length);
+	uint32_t crc32(const void* data, uint32_t length);
+
+#endif	// CRC32_H
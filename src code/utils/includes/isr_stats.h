@@ -0,0 +1,51 @@
+/**
+ * @file	isr_stats.h
+ * @brief	Header file with definitions, macros and function prototypes
+ *			used to keep per interrupt handler call counts and execution time.
+ * @author	Manuel Burnay
+ * @date	2026.10.18 (Created)
+ * @date	2026.10.18 (Last Modified)
+ */
+
+#ifndef ISR_STATS_H
+	#define ISR_STATS_H
+
+    #include <stdint.h>
+    #include "cpu.h"
+
+	/**
+	 * @brief   Instrumented interrupt handlers.
+	 */
+	enum ISR_IDS{ISR_UART0, ISR_SYSTICK, ISR_GPIOL, ISR_UART2, ISR_UART3, ISR_COUNT};
+
+	/**
+	 * @brief	interrupt handler statistics structure.
+	 * @details Both counters are free running (they wrap), so only differences between samples are meaningful.
+	 *          cycles includes the time spent in any interrupt that preempted the handler.
+	 */
+	typedef struct isr_stat_{
+		uint32_t count;
+		uint32_t cycles;
+	} isr_stat_t;
+
+	extern isr_stat_t isr_stats[ISR_COUNT];
+	extern const char* const ISR_NAMES[ISR_COUNT];
+
+	/**
+	 * @brief   Stamps the entry of an interrupt handler, place it before the handler's first statement.
+	 * @details The DWT cycle counter must be running (see CYCCNT_ENABLE).
+	 */
+	#define ISR_STATS_ENTER()	uint32_t isr_stats_start = CYCCNT()
+
+	/**
+	 * @brief   Accounts an interrupt handler call, place it after the handler's last statement.
+	 */
+	#define ISR_STATS_EXIT(id) do {								\
+		isr_stats[id].count++;								\
+		isr_stats[id].cycles += CYCCNT() - isr_stats_start;	\
+	} while (0)
+
+
+	void isr_stats_sample(isr_stat_t* dst);
+
+#endif	// ISR_STATS_H
@@ -0,0 +1,57 @@
+/**
+ * @file	lz_stream.h
+ * @brief	Header file with definitions, structures and function prototypes
+ *			used to operate the streaming LZ77 compressor.
+ * @author	Manuel Burnay
+ * @date	2026.10.18 (Created)
+ * @date	2026.10.18 (Last Modified)
+ *
+ * @details Stream format, one control byte followed by its payload:
+ *          - 0x00..0x7F:   literal run, (c + 1) literal bytes follow.
+ *          - 0x80..0xFE:   match, length (c & 0x7F) + LZ_MIN_MATCH,
+ *                          followed by one byte with (offset - 1), offset counted back from the current output.
+ *          - 0xFF:         end of stream.
+ */
+
+#ifndef LZ_STREAM_H
+	#define LZ_STREAM_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+	#define LZ_WINDOW_SIZE  256     /// History window size (max match offset)
+	#define LZ_WINDOW_MASK  (LZ_WINDOW_SIZE-1)
+	#define LZ_HASH_BITS    8
+	#define LZ_HASH_SIZE    (1 << LZ_HASH_BITS)     /// Match finder hash table size
+
+	#define LZ_MIN_MATCH    3
+	#define LZ_MAX_MATCH    (0x7E + LZ_MIN_MATCH)
+	#define LZ_MAX_LITERALS 128
+
+	#define LZ_CTRL_MATCH   0x80
+	#define LZ_CTRL_END     0xFF
+
+	/**
+	 * @brief   Max compressed size of a chunk of length bytes
+	 *          (incompressible data costs a control byte per LZ_MAX_LITERALS bytes).
+	 */
+	#define LZ_BOUND(length)    ((length) + ((length) + LZ_MAX_LITERALS - 1)/LZ_MAX_LITERALS)
+
+	/**
+	 * @brief	LZ compressor stream state.
+	 * @details head holds the low 16 bits of (stream position + 1) where each 3-byte hash was last seen, 0 if never.
+	 *          Entries older than 64K bytes alias newer positions, which is harmless:
+	 *          every candidate is verified against the window before it's used.
+	 */
+	typedef struct lz_stream_{
+		uint8_t     window[LZ_WINDOW_SIZE];
+		uint16_t    head[LZ_HASH_SIZE];
+		uint32_t    pos;
+	} lz_stream_t;
+
+
+	// LZ stream function prototypes
+	void lz_init(lz_stream_t* lz);
+	uint32_t lz_compress(lz_stream_t* lz, const uint8_t* src, uint32_t length, uint8_t* dst);
+
+#endif	// LZ_STREAM_H
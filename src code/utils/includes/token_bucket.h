@@ -0,0 +1,35 @@
+/**
+ * @file	token_bucket.h
+ * @brief	Header file with definitions and function prototypes
+ *			used to operate a token bucket rate limiter.
+ * @author	Manuel Burnay
+ * @date	2026.10.18 (Created)
+ * @date	2026.10.18 (Last Modified)
+ */
+
+#ifndef TOKEN_BUCKET_H
+	#define TOKEN_BUCKET_H
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+	/**
+	 * @brief	token bucket structure.
+	 * @details The bucket holds up to capacity tokens (the allowed burst),
+	 *          and gets a token back every period ticks (the sustained rate).
+	 */
+	typedef struct token_bucket_{
+		uint16_t tokens;
+		uint16_t capacity;
+		uint16_t period;
+		uint16_t ticks;
+	} token_bucket_t;
+
+
+	// Token bucket function prototypes
+	void token_bucket_init(token_bucket_t* bucket, uint16_t capacity, uint16_t period);
+	void token_bucket_tick(token_bucket_t* bucket);
+	bool token_bucket_available(token_bucket_t* bucket);
+	void token_bucket_take(token_bucket_t* bucket);
+
+#endif	// TOKEN_BUCKET_H
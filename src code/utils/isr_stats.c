@@ -0,0 +1,27 @@
+/**
+ * @file   isr_stats.c
+ * @brief  C file all function definitions regarding interrupt handler statistics.
+ * @author Manuel Burnay
+ * @date   2026.10.18 (Created)
+ * @date   2026.10.18 (Last Modified)
+ */
+
+
+#include <string.h>
+#include "isr_stats.h"
+
+isr_stat_t isr_stats[ISR_COUNT];   /// Per handler statistics, updated by ISR_STATS_EXIT
+
+/** Interrupt handler names, in ISR_IDS order */
+const char* const ISR_NAMES[ISR_COUNT] = {"uart0", "systick", "gpiol", "uart2", "uart3"};
+
+/**
+ * @brief  Takes a consistent copy of every handler's statistics.
+ * @param  [out] dst: array of ISR_COUNT statistics the sample is copied to.
+ */
+void isr_stats_sample(isr_stat_t* dst)
+{
+    DISABLE_IRQ();
+    memcpy(dst, isr_stats, sizeof(isr_stats));
+    ENABLE_IRQ();
+}
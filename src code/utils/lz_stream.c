@@ -0,0 +1,119 @@
+/**
+ * @file   lz_stream.c
+ * @brief  C file all function definitions regarding the streaming LZ77 compressor.
+ * @author Manuel Burnay
+ * @date   2026.10.18 (Created)
+ * @date   2026.10.18 (Last Modified)
+ *
+ * @details Greedy LZ77 with a single-entry hash chain and a 256 byte window,
+ *          so the whole state stays under 800 bytes and compressing is a hash and a compare per byte.
+ *          Data is compressed chunk by chunk as it becomes available,
+ *          matches can reach back into previous chunks, but never past the end of the current one.
+ */
+
+
+#include <string.h>
+#include "lz_stream.h"
+
+/** Multiplicative hash of the next 3 bytes (a single-cycle multiply on the C-M4) */
+#define LZ_HASH(p)  (((((uint32_t)(p)[0] << 16) | ((p)[1] << 8) | (p)[2]) * 2654435761u) >> (32 - LZ_HASH_BITS))
+
+static uint32_t lz_flush_literals(const uint8_t* lit, uint32_t lit_len, uint8_t* dst);
+
+/**
+ * @brief  Initializes an LZ stream (empty history).
+ * @param  [out] lz: pointer to LZ stream being initialized.
+ */
+void lz_init(lz_stream_t* lz)
+{
+    memset(lz->head, 0, sizeof(lz->head));
+    lz->pos = 0;
+}
+
+/**
+ * @brief   Compresses the next chunk of a stream.
+ * @param   [in, out] lz: pointer to LZ stream being used.
+ * @param   [in] src: chunk to be compressed.
+ * @param   [in] length: chunk length.
+ * @param   [out] dst: where the compressed chunk is written, must fit LZ_BOUND(length) bytes.
+ * @return  [uint32_t] Compressed chunk length.
+ * @details The end of stream marker isn't written, put LZ_CTRL_END after the last chunk.
+ */
+uint32_t lz_compress(lz_stream_t* lz, const uint8_t* src, uint32_t length, uint8_t* dst)
+{
+    uint32_t i = 0, out = 0, lit_start = 0;
+    uint32_t match_pos, match_len, offset, h, p;
+    uint16_t cand, dist;
+    uint8_t c;
+
+    while (i < length) {
+        match_len = 0;
+
+        if (length - i >= LZ_MIN_MATCH) {
+            h = LZ_HASH(src+i);
+            cand = lz->head[h];
+            lz->head[h] = lz->pos + 1;
+            dist = (uint16_t)lz->pos - (uint16_t)(cand - 1);
+
+            if (cand && dist != 0 && dist <= LZ_WINDOW_SIZE && dist <= lz->pos) {
+                match_pos = lz->pos - dist;
+
+                // bytes before the current position are in the window, the rest are still in src
+                while (match_len < LZ_MAX_MATCH && i + match_len < length) {
+                    p = match_pos + match_len;
+                    c = (p < lz->pos) ? lz->window[p & LZ_WINDOW_MASK] : src[i + (p - lz->pos)];
+                    if (c != src[i + match_len]) break;
+                    match_len++;
+                }
+            }
+        }
+
+        if (match_len >= LZ_MIN_MATCH) {
+            out += lz_flush_literals(src + lit_start, i - lit_start, dst + out);
+
+            offset = lz->pos - match_pos;
+            dst[out++] = LZ_CTRL_MATCH | (match_len - LZ_MIN_MATCH);
+            dst[out++] = offset - 1;
+
+            // keep the hash table current through the match, so later matches can start inside it
+            while (match_len--) {
+                if (length - i >= LZ_MIN_MATCH) {
+                    lz->head[LZ_HASH(src+i)] = lz->pos + 1;
+                }
+                lz->window[lz->pos & LZ_WINDOW_MASK] = src[i++];
+                lz->pos++;
+            }
+            lit_start = i;
+        }
+        else {
+            lz->window[lz->pos & LZ_WINDOW_MASK] = src[i++];
+            lz->pos++;
+        }
+    }
+
+    out += lz_flush_literals(src + lit_start, i - lit_start, dst + out);
+
+    return out;
+}
+
+/**
+ * @brief   Writes a run of literals, split into LZ_MAX_LITERALS sized runs.
+ * @return  [uint32_t] Amount of bytes written.
+ */
+static uint32_t lz_flush_literals(const uint8_t* lit, uint32_t lit_len, uint8_t* dst)
+{
+    uint32_t out = 0, run;
+
+    while (lit_len) {
+        run = (lit_len > LZ_MAX_LITERALS) ? LZ_MAX_LITERALS : lit_len;
+
+        dst[out++] = run - 1;
+        memcpy(dst + out, lit, run);
+
+        out += run;
+        lit += run;
+        lit_len -= run;
+    }
+
+    return out;
+}
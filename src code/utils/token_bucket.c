@@ -0,0 +1,58 @@
+/**
+ * @file   token_bucket.c
+ * @brief  C file all function definitions regarding token bucket operation.
+ * @author Manuel Burnay
+ * @date   2026.10.18 (Created)
+ * @date   2026.10.18 (Last Modified)
+ */
+
+
+#include "token_bucket.h"
+
+/**
+ * @brief  Initializes a token bucket structure (full).
+ * @param  [out] bucket: pointer to token bucket structure being initialized.
+ * @param  [in] capacity: max amount of tokens (burst size).
+ * @param  [in] period: ticks per token refilled (1 / rate).
+ */
+void token_bucket_init(token_bucket_t* bucket, uint16_t capacity, uint16_t period)
+{
+    bucket->tokens = capacity;
+    bucket->capacity = capacity;
+    bucket->period = period;
+    bucket->ticks = 0;
+}
+
+/**
+ * @brief   Refills a token bucket, meant to be called every tick.
+ * @param   [in, out] bucket: pointer to token bucket being used.
+ */
+void token_bucket_tick(token_bucket_t* bucket)
+{
+    if (bucket->tokens < bucket->capacity && ++bucket->ticks >= bucket->period) {
+        bucket->ticks = 0;
+        bucket->tokens++;
+    }
+}
+
+/**
+ * @brief   Checks if a token bucket has a token to spare.
+ * @param   [in] bucket: pointer to token bucket being used.
+ * @return  [bool] True if a token can be taken.
+ */
+bool token_bucket_available(token_bucket_t* bucket)
+{
+    return (bucket->tokens != 0);
+}
+
+/**
+ * @brief   Takes a token from a token bucket.
+ * @param   [in, out] bucket: pointer to token bucket being used.
+ * @details Check token_bucket_available() first, taking from an empty bucket does nothing.
+ */
+void token_bucket_take(token_bucket_t* bucket)
+{
+    if (bucket->tokens) {
+        bucket->tokens--;
+    }
+}